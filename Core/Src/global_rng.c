@@ -1,17 +1,38 @@
 #include "global_rng.h"
-#include "stm32f4xx_hal.h"
+#include "params.h"
+#include "rng_pool.h"
+#include "rng_source.h"
+#include "masked_prg.h"
 
 /**
- * Generate a fresh 64-bit random value using the STM32 hardware RNG.
+ * Generate a fresh 64-bit random value from the entropy source.
  *
- * This function pulls two 32-bit words from the RNG and combines them
- * into a single 64-bit result. Used for generating random shares or
- * randomness matrices in secure masking.
+ * With MASKED_RNG_POOL the two 32-bit words come from the interrupt-fed
+ * pool, so no peripheral access happens here. Otherwise they are taken
+ * directly from the MASKED_RNG_SOURCE backend (on target: the hardware RNG,
+ * polled until the HAL reports a valid word).
  */
-
-uint64_t get_random64(void) {
-    uint32_t r1, r2;
-    HAL_RNG_GenerateRandomNumber(&hrng, &r1);
-    HAL_RNG_GenerateRandomNumber(&hrng, &r2);
+uint64_t get_trng64(void) {
+#if MASKED_RNG_POOL
+    return rng_pool_get64();
+#else
+    uint32_t r1 = rng_source_word();
+    uint32_t r2 = rng_source_word();
     return ((uint64_t)r1 << 32) | r2;
+#endif
+}
+
+/**
+ * Generate a fresh 64-bit random value for masking.
+ *
+ * Used for generating random shares or randomness matrices in secure masking.
+ * With MASKED_RNG_PRG the value comes from the TRNG-seeded ChaCha expander,
+ * otherwise directly from the TRNG.
+ */
+MASKED_RAMFUNC uint64_t get_random64(void) {
+#if MASKED_RNG_PRG
+    return prg_random64();
+#else
+    return get_trng64();
+#endif
 }
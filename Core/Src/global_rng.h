@@ -1,10 +1,14 @@
 #ifndef GLOBAL_RNG_H
 #define GLOBAL_RNG_H
 
-#include "stm32f4xx_hal.h"
+#include <stdint.h>
 
-// Declare hrng as external so other files can use it
-extern RNG_HandleTypeDef hrng;
+// 64 bits straight from the entropy source (via the pool when MASKED_RNG_POOL is set).
+// get_random64() may instead return PRG output; use this for seeding.
+uint64_t get_trng64(void);
+
+// 64 bits of masking randomness (PRG output with MASKED_RNG_PRG).
+uint64_t get_random64(void);
 
 
 #endif
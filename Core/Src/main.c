@@ -26,6 +26,9 @@
 #include <string.h>
 #include <stdio.h>
 #include "sha_shake.h"
+#include "masked_bench.h"
+#include "rng_pool.h"
+#include "masked_keccak_soa.h"
 
 /* USER CODE END Includes */
 
@@ -128,6 +131,17 @@ int main(void)
   __HAL_RCC_RNG_CLK_ENABLE();
   HAL_RNG_Init(&hrng);
   setvbuf(stdout, NULL, _IONBF, 0); // Disable buffering completely
+  rng_pool_init(); // Start filling the randomness pool in the background
+
+#if MASKED_KECCAK_ASM
+  // Never hash with an assembly kernel that disagrees with the C round.
+  if (masked_soa_keccak_asm_check() != 0)
+    Error_Handler();
+#endif
+
+#ifdef MASKED_BENCH
+  masked_bench_run();
+#endif
 
   /* USER CODE END 2 */
 
@@ -0,0 +1,785 @@
+#include "masked_bench.h"
+#include "masked_keccak.h"
+#include "masked_gadgets.h"
+#include "masked_keccak_bi32.h"
+#include "masked_keccak_soa.h"
+#include "masked_prg.h"
+#include "global_rng.h"
+#include "sha_shake.h"
+#include "masked_ccm.h"
+#include "params.h"
+#include <stdio.h>
+#ifdef __arm__
+#include "stm32f4xx_hal.h"
+#elif defined(__x86_64__) || defined(__i386__)
+#include <time.h>
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+// Permutations timed per measurement; the average is reported.
+#define BENCH_ITERATIONS 4
+
+#ifdef __arm__
+void bench_cycle_counter_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t bench_cycles(void) {
+    return DWT->CYCCNT;
+}
+
+uint32_t bench_clock_hz(void) {
+    return SystemCoreClock;
+}
+#else
+// Host stand-in: the x86 time-stamp counter, or clock_gettime() nanoseconds
+// elsewhere. Only differences are used, so 32-bit wrap-around is harmless
+// for intervals below 2^32 ticks.
+static uint32_t bench_host_hz;
+
+static uint64_t bench_host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+uint32_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    return (uint32_t)bench_host_ns();
+#endif
+}
+
+//Tick rate of bench_cycles(), measured against the monotonic clock over 10 ms.
+void bench_cycle_counter_init(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t t0 = bench_host_ns(), t1;
+    uint64_t c0 = __rdtsc();
+
+    do {
+        t1 = bench_host_ns();
+    } while (t1 - t0 < 10000000u);
+    bench_host_hz = (uint32_t)((__rdtsc() - c0) * 1000000000u / (t1 - t0));
+#else
+    bench_host_hz = 1000000000u;
+#endif
+}
+
+uint32_t bench_clock_hz(void) {
+    return bench_host_hz;
+}
+#endif
+
+static void bench_report_value(const char *name, unsigned long value, const char *unit) {
+    printf("%s,%d,%lu,%s\n", name, MASKING_ORDER, value, unit);
+}
+
+static void bench_report(const char *name, uint32_t total_cycles) {
+    bench_report_value(name, (unsigned long)(total_cycles / BENCH_ITERATIONS), "cycles");
+}
+
+//Fill a masked state with fixed test lanes so every run does the same work.
+static void bench_state_init(masked_uint64_t state[5][5]) {
+    for (int x = 0; x < 5; x++)
+        for (int y = 0; y < 5; y++)
+            masked_value_set(&state[x][y], 0x0123456789ABCDEFULL * (uint64_t)(x + 5 * y + 1));
+}
+
+/**
+ * Where the time goes inside one reference round (masked_keccak_round):
+ * cycles per call of each step, then the 25 fill_random_matrix() calls
+ * that supply one Chi step, and the whole permutation of this build.
+ * masked_chi is timed with its randomness already drawn, so
+ * "step_chi" + "step_chi_random" is what the round pays for Chi.
+ * TI builds time the guarded row Chi instead ("step_chi_ti") and the
+ * guard refresh that each permutation pays once ("f1600_chi_guards").
+ */
+void masked_bench_steps(void) {
+    static masked_uint64_t state[5][5], out[5][5];
+    static uint64_t r[5][5][MASKING_N][MASKING_N];
+    uint32_t start;
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_theta(state);
+    bench_report("step_theta", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_rho(state);
+    bench_report("step_rho", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_pi(state);
+    bench_report("step_pi", bench_cycles() - start);
+
+#if MASKED_TI
+    // The TI round draws no Chi randomness; the guards are drawn once per
+    // permutation and the five rows run through ti_chi_row().
+    (void)r;
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        ti_chi_guard_refresh();
+    bench_report("f1600_chi_guards", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++) {
+        for (int y = 0; y < 5; y++) {
+            masked_uint64_t row[5], row_out[5];
+            for (int x = 0; x < 5; x++)
+                row[x] = state[x][y];
+            ti_chi_row(row_out, row);
+            for (int x = 0; x < 5; x++)
+                out[x][y] = row_out[x];
+        }
+    }
+    bench_report("step_chi_ti", bench_cycles() - start);
+#else
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        for (int x = 0; x < 5; x++)
+            for (int y = 0; y < 5; y++)
+                fill_random_matrix(r[x][y]);
+    bench_report("step_chi_random", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_chi(out, state, r);
+    bench_report("step_chi", bench_cycles() - start);
+#endif
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_iota(out, RC[n % NROUNDS]);
+    bench_report("step_iota", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_keccak_round(state, RC[n % NROUNDS]);
+    bench_report("round_lane64", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_keccak_f1600(state);
+    bench_report("f1600", bench_cycles() - start);
+}
+
+#define BENCH_HASH_SIZES 5
+
+static const size_t bench_hash_sizes[BENCH_HASH_SIZES] = { 0, 16, 64, 256, 1024 };
+
+//Report one hash at one message size as cycles and, for non-empty
+// messages, cycles per input byte.
+static void bench_report_hash(const char *hash, size_t len, uint32_t total_cycles) {
+    char name[40];
+    uint32_t cycles = total_cycles / BENCH_ITERATIONS;
+
+    snprintf(name, sizeof(name), "%s_%uB", hash, (unsigned)len);
+    bench_report_value(name, cycles, "cycles");
+    if (len > 0)
+        bench_report_value(name, cycles / len, "cycles/byte");
+}
+
+/**
+ * Every one-shot SHA3/SHAKE front-end over 0 to 1024-byte secret messages:
+ * full digests for SHA3, 32 bytes of output for SHAKE.
+ */
+void masked_bench_hashes(void) {
+    static uint8_t msg[1024], out[64];
+    uint32_t start;
+
+    for (size_t i = 0; i < sizeof(msg); i++)
+        msg[i] = (uint8_t)i;
+
+    for (int s = 0; s < BENCH_HASH_SIZES; s++) {
+        const size_t len = bench_hash_sizes[s];
+
+        start = bench_cycles();
+        for (int n = 0; n < BENCH_ITERATIONS; n++)
+            masked_sha3_224(out, msg, len);
+        bench_report_hash("sha3_224", len, bench_cycles() - start);
+
+        start = bench_cycles();
+        for (int n = 0; n < BENCH_ITERATIONS; n++)
+            masked_sha3_256(out, msg, len);
+        bench_report_hash("sha3_256", len, bench_cycles() - start);
+
+        start = bench_cycles();
+        for (int n = 0; n < BENCH_ITERATIONS; n++)
+            masked_sha3_384(out, msg, len);
+        bench_report_hash("sha3_384", len, bench_cycles() - start);
+
+        start = bench_cycles();
+        for (int n = 0; n < BENCH_ITERATIONS; n++)
+            masked_sha3_512(out, msg, len);
+        bench_report_hash("sha3_512", len, bench_cycles() - start);
+
+        start = bench_cycles();
+        for (int n = 0; n < BENCH_ITERATIONS; n++)
+            masked_shake128(out, 32, msg, len);
+        bench_report_hash("shake128", len, bench_cycles() - start);
+
+        start = bench_cycles();
+        for (int n = 0; n < BENCH_ITERATIONS; n++)
+            masked_shake256(out, 32, msg, len);
+        bench_report_hash("shake256", len, bench_cycles() - start);
+    }
+}
+
+/**
+ * Compare the lane-major reference round against the share-major layout.
+ *
+ * "lane64" runs the reference round function directly, independent of the
+ * MASKED_KECCAK_BACKEND selection; "fused" is the same layout with the
+ * copy-free fused round and "lanecomp" the fused round on a
+ * lane-complemented state. "soa" times the share-major permutation
+ * on an already transposed state; "soa+convert" adds the transposition in
+ * and out, which is what masked_keccak_f1600() pays with that backend.
+ */
+void masked_bench_layouts(void) {
+    static masked_uint64_t state[5][5];
+    static masked_soa_state_t soa;
+    uint32_t start;
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        for (int i = 0; i < NROUNDS; i++)
+            masked_keccak_round(state, RC[i]);
+    bench_report("f1600_lane64", bench_cycles() - start);
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        for (int i = 0; i < NROUNDS; i++)
+            masked_keccak_round_fused(state, RC[i]);
+    bench_report("f1600_fused", bench_cycles() - start);
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        for (int i = 0; i < NROUNDS; i++)
+            masked_keccak_round_lanecomp(state, RC[i]);
+    bench_report("f1600_lanecomp", bench_cycles() - start);
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_keccak_f1600_bi32(state);
+    bench_report("f1600_bi32", bench_cycles() - start);
+
+    bench_state_init(state);
+    masked_soa_from_state(&soa, state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_soa_keccak_f1600(&soa);
+    bench_report("f1600_soa", bench_cycles() - start);
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_keccak_f1600_soa(state);
+    bench_report("f1600_soa+convert", bench_cycles() - start);
+}
+
+/**
+ * Cycles spent in Iota over one permutation (24 rounds), for the legacy
+ * recombine-and-remask Iota and the linear share-0 Iota, plus the saving.
+ */
+void masked_bench_iota(void) {
+    static masked_uint64_t state[5][5];
+    uint32_t start, remask, linear;
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        for (int i = 0; i < NROUNDS; i++)
+            masked_iota_remask(state, RC[i]);
+    remask = bench_cycles() - start;
+    bench_report("iota_remask_per_f1600", remask);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        for (int i = 0; i < NROUNDS; i++)
+            masked_iota_linear(state, RC[i]);
+    linear = bench_cycles() - start;
+    bench_report("iota_linear_per_f1600", linear);
+
+    bench_report("iota_saved_per_f1600", remask - linear);
+}
+
+/**
+ * Cost of masking randomness and its effect on hash throughput.
+ *
+ * Reports cycles per 64-bit word from the TRNG path (pool or polling, after
+ * draining the pool so the refill rate is what is measured) and from the
+ * ChaCha expander, then SHA3-256 of a 64-byte message as cycles and
+ * hashes per second with the get_random64() source this build selected.
+ */
+void masked_bench_rng(void) {
+    static uint8_t msg[64], digest[32];
+    volatile uint64_t sink = 0;
+    uint32_t start, cycles;
+
+    for (int i = 0; i < 1024; i++)
+        sink ^= get_trng64();
+    start = bench_cycles();
+    for (int i = 0; i < 1024; i++)
+        sink ^= get_trng64();
+    bench_report_value("rng_trng64_per_word", (bench_cycles() - start) / 1024, "cycles");
+
+    prg_reseed();
+    start = bench_cycles();
+    for (int i = 0; i < 1024; i++)
+        sink ^= prg_random64();
+    bench_report_value("rng_prg64_per_word", (bench_cycles() - start) / 1024, "cycles");
+    (void)sink;
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_sha3_256(digest, msg, sizeof(msg));
+    cycles = (bench_cycles() - start) / BENCH_ITERATIONS;
+#if MASKED_RNG_PRG
+    bench_report_value("sha3_256_64B_prg", cycles, "cycles");
+    bench_report_value("sha3_256_64B_prg", bench_clock_hz() / cycles, "hashes/s");
+#else
+    bench_report_value("sha3_256_64B_trng", cycles, "cycles");
+    bench_report_value("sha3_256_64B_trng", bench_clock_hz() / cycles, "hashes/s");
+#endif
+}
+
+/**
+ * Shared-prefix hashing, Kyber XOF(rho, i, j) pattern: a 34-byte secret
+ * seed followed by a 2-byte public index, one SHAKE128 block out.
+ *
+ * "reabsorb" starts every hash from zero and re-masks the seed;
+ * "clone" absorbs the seed once and copies the snapshot per index,
+ * with and without refreshing the shares of the copy.
+ */
+void masked_bench_prefix(void) {
+    static uint8_t seed[34], block[168];
+    static masked_keccak_ctx prefix, xof;
+    uint8_t index[2] = { 0, 0 };
+    uint32_t start;
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++) {
+        index[0] = (uint8_t)n;
+        masked_keccak_init(&xof, 168, DOMAIN_SHAKE);
+        masked_keccak_absorb(&xof, seed, sizeof(seed));
+        masked_keccak_absorb_public(&xof, index, sizeof(index));
+        masked_keccak_squeeze(&xof, block, sizeof(block));
+    }
+    bench_report("xof_34+2B_reabsorb", bench_cycles() - start);
+
+    masked_keccak_init(&prefix, 168, DOMAIN_SHAKE);
+    masked_keccak_absorb(&prefix, seed, sizeof(seed));
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++) {
+        index[0] = (uint8_t)n;
+        masked_keccak_clone(&xof, &prefix, 0);
+        masked_keccak_absorb_public(&xof, index, sizeof(index));
+        masked_keccak_squeeze(&xof, block, sizeof(block));
+    }
+    bench_report("xof_34+2B_clone", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++) {
+        index[0] = (uint8_t)n;
+        masked_keccak_clone(&xof, &prefix, 1);
+        masked_keccak_absorb_public(&xof, index, sizeof(index));
+        masked_keccak_squeeze(&xof, block, sizeof(block));
+    }
+    bench_report("xof_34+2B_clone_refresh", bench_cycles() - start);
+}
+
+/**
+ * 12-round Keccak-p against 24-round Keccak-f, and the front-ends built on
+ * them: SHAKE128 vs. TurboSHAKE128 vs. KangarooTwelve over the same
+ * 64-byte secret message, 168 bytes out.
+ */
+void masked_bench_turboshake(void) {
+    static masked_uint64_t state[5][5];
+    static uint8_t msg[64], out[168];
+    uint32_t start;
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_keccak_p1600(state, TURBOSHAKE_ROUNDS);
+    bench_report("p1600_12rounds", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_shake128(out, sizeof(out), msg, sizeof(msg));
+    bench_report("shake128_64B_168out", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_turboshake128(out, sizeof(out), msg, sizeof(msg), DOMAIN_TURBOSHAKE);
+    bench_report("turboshake128_64B", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_kangarootwelve(out, sizeof(out), msg, sizeof(msg), NULL, 0);
+    bench_report("kangarootwelve_64B", bench_cycles() - start);
+}
+
+/**
+ * Chi randomness: fresh 64-bit words and cycles spent drawing them per
+ * permutation (120 Chi rows) for the ISW gadgets and, in first-order
+ * builds, the recycled ones; then the whole permutation and the Chi
+ * randomness per permutation of the gadget this build ships.
+ */
+void masked_bench_chi(void) {
+    static masked_uint64_t state[5][5];
+    static uint64_t r[5][MASKING_N][MASKING_N];
+    uint32_t start;
+
+    bench_report_value("chi_isw_random_per_f1600", 5 * 24 * CHI_ISW_WORDS_PER_ROW, "words");
+    start = bench_cycles();
+    for (int n = 0; n < 5 * 24; n++)
+        chi_random_isw(r);
+    bench_report_value("chi_isw_random_per_f1600", bench_cycles() - start, "cycles");
+
+#if MASKING_ORDER == 1
+    bench_report_value("chi_recycled_random_per_f1600", 5 * 24 * CHI_RECYCLED_WORDS_PER_ROW, "words");
+    start = bench_cycles();
+    for (int n = 0; n < 5 * 24; n++)
+        chi_random_recycled(r);
+    bench_report_value("chi_recycled_random_per_f1600", bench_cycles() - start, "cycles");
+#endif
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_keccak_f1600(state);
+#if MASKED_TI
+    bench_report("f1600_chi_ti", bench_cycles() - start);
+#elif MASKED_CHI_GADGET == MASKED_CHI_RECYCLED
+    bench_report("f1600_chi_recycled", bench_cycles() - start);
+#else
+    bench_report("f1600_chi_isw", bench_cycles() - start);
+#endif
+    bench_report_value("f1600_chi_random", CHI_WORDS_PER_F1600, "words");
+}
+
+/**
+ * SHAKE128 throughput in cycles per input byte (1 KiB secret message,
+ * 32 bytes out), labelled with the masking mode of this build. Compare a
+ * MASKED_TI=1 build against a MASKING_ORDER=1 build with the ISW gadgets.
+ */
+void masked_bench_throughput(void) {
+    static uint8_t msg[1024], out[32];
+    uint32_t start, cycles;
+
+    start = bench_cycles();
+    masked_shake128(out, sizeof(out), msg, sizeof(msg));
+    cycles = bench_cycles() - start;
+#if MASKED_TI
+    bench_report_value("shake128_1KiB_ti", cycles / sizeof(msg), "cycles/byte");
+#elif MASKED_CHI_GADGET == MASKED_CHI_RECYCLED
+    bench_report_value("shake128_1KiB_recycled", cycles / sizeof(msg), "cycles/byte");
+#else
+    bench_report_value("shake128_1KiB_isw", cycles / sizeof(msg), "cycles/byte");
+#endif
+}
+
+/**
+ * Cycles per masked_chi() (one full Chi step, 25 masked ANDs) with the
+ * randomness drawn beforehand, so only the gadgets are timed. Run one
+ * build per MASKING_ORDER; MASKED_UNROLLED_GADGETS=0 gives the generic
+ * loop gadgets for comparison.
+ */
+void masked_bench_gadgets(void) {
+    static masked_uint64_t state[5][5], out[5][5];
+    static uint64_t r[5][5][MASKING_N][MASKING_N];
+    uint32_t start;
+
+    bench_state_init(state);
+    for (int x = 0; x < 5; x++)
+        for (int y = 0; y < 5; y++)
+            fill_random_matrix(r[x][y]);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_chi(out, state, r);
+#if MASKED_UNROLLED_GADGETS && MASKING_N >= 2 && MASKING_N <= 5
+    bench_report("masked_chi_unrolled", bench_cycles() - start);
+#else
+    bench_report("masked_chi_generic", bench_cycles() - start);
+#endif
+}
+
+/**
+ * Thumb-2 kernel (MASKED_KECCAK_ASM=1): number of lanes where it disagrees
+ * with the C round (main() has already stopped if this is not 0), then
+ * cycles for one Theta/Rho/Pi on one share in C and in assembly and, when
+ * the whole permutation is in assembly, for one masked_soa_keccak_p1600_asm().
+ * Prints nothing in builds without the kernel.
+ */
+void masked_bench_asm(void) {
+#if MASKED_KECCAK_ASM
+    static uint64_t A[25];
+    uint32_t start;
+
+    bench_report_value("asm_mismatches", masked_soa_keccak_asm_check(), "lanes");
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        keccak_linear_layer(A);
+    bench_report("linear_layer_c", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        keccak_linear_layer_asm(A);
+    bench_report("linear_layer_asm", bench_cycles() - start);
+
+#if MASKED_KECCAK_ASM_ROUND
+    static masked_soa_state_t S;
+    static uint64_t r[5][MASKING_N][MASKING_N];
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_soa_keccak_p1600_asm(&S, NROUNDS, r);
+    bench_report("f1600_soa_asm", bench_cycles() - start);
+#endif
+#endif
+}
+
+/**
+ * Batching: four permutations one after another vs. masked_keccak_p1600_x4,
+ * and four SHAKE128 calls vs. one masked_shake128_x4. All figures are per
+ * four messages.
+ */
+void masked_bench_batch(void) {
+    static masked_uint64_t state[4][5][5];
+    static uint8_t msg[4][64], out[4][168];
+    const uint8_t *const in[4] = { msg[0], msg[1], msg[2], msg[3] };
+    uint8_t *const outp[4] = { out[0], out[1], out[2], out[3] };
+    uint32_t start;
+
+    for (int i = 0; i < 4; i++)
+        bench_state_init(state[i]);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        for (int i = 0; i < 4; i++)
+            masked_keccak_f1600(state[i]);
+    bench_report("f1600_4x_serial", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_keccak_p1600_x4(state, NROUNDS);
+    bench_report("f1600_x4", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        for (int i = 0; i < 4; i++)
+            masked_shake128(out[i], sizeof(out[i]), msg[i], sizeof(msg[i]));
+    bench_report("shake128_64B_4x_serial", bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_shake128_x4(outp, sizeof(out[0]), in, sizeof(msg[0]));
+    bench_report("shake128_64B_x4", bench_cycles() - start);
+}
+
+#if MASKED_CCM_PLACEMENT
+#ifdef __arm__
+// Bus traffic for the CCM rows: DMA2 stream 0 (the only controller that can
+// copy memory to memory) copies one SRAM buffer into another, and the
+// transfer-complete interrupt starts the next copy at once. While it runs,
+// SRAM and the bus matrix see a DMA read and write every few cycles. The
+// restart interrupt is part of the load and is timed with it.
+#define BENCH_DMA_WORDS 4096
+
+static uint32_t bench_dma_buf[2][BENCH_DMA_WORDS];
+static DMA_HandleTypeDef bench_dma;
+static volatile uint32_t bench_dma_copies;
+static volatile int bench_dma_running;
+
+void DMA2_Stream0_IRQHandler(void) {
+    HAL_DMA_IRQHandler(&bench_dma);
+}
+
+static void bench_dma_restart(DMA_HandleTypeDef *hdma) {
+    bench_dma_copies++;
+    if (bench_dma_running)
+        HAL_DMA_Start_IT(hdma, (uint32_t)bench_dma_buf[0], (uint32_t)bench_dma_buf[1], BENCH_DMA_WORDS);
+}
+
+static void bench_dma_init(void) {
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    bench_dma.Instance = DMA2_Stream0;
+    bench_dma.Init.Channel = DMA_CHANNEL_0;
+    bench_dma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+    bench_dma.Init.PeriphInc = DMA_PINC_ENABLE;
+    bench_dma.Init.MemInc = DMA_MINC_ENABLE;
+    bench_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    bench_dma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    bench_dma.Init.Mode = DMA_NORMAL;
+    bench_dma.Init.Priority = DMA_PRIORITY_HIGH;
+    bench_dma.Init.FIFOMode = DMA_FIFOMODE_ENABLE;
+    bench_dma.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+    bench_dma.Init.MemBurst = DMA_MBURST_SINGLE;
+    bench_dma.Init.PeriphBurst = DMA_PBURST_SINGLE;
+    HAL_DMA_Init(&bench_dma);
+    bench_dma.XferCpltCallback = bench_dma_restart;
+
+    HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, 15, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+}
+
+static void bench_dma_start(void) {
+    bench_dma_copies = 0;
+    bench_dma_running = 1;
+    HAL_DMA_Start_IT(&bench_dma, (uint32_t)bench_dma_buf[0], (uint32_t)bench_dma_buf[1], BENCH_DMA_WORDS);
+}
+
+//Let the copy in flight finish without starting another.
+static void bench_dma_stop(void) {
+    bench_dma_running = 0;
+    while (HAL_DMA_GetState(&bench_dma) == HAL_DMA_STATE_BUSY) {
+    }
+}
+#endif
+
+typedef struct {
+    masked_keccak_workspace_t *ws;
+    int dma;            // Run the DMA copy loop during the timed permutations
+    uint32_t cycles;
+} bench_ws_run_t;
+
+//Time BENCH_ITERATIONS workspace permutations, with the DMA copy loop
+// running for the whole timed window if run->dma is set.
+static void bench_ws_f1600(void *arg) {
+    bench_ws_run_t *run = arg;
+
+    run->cycles = 0;
+    bench_state_init(run->ws->ctx.state);
+#ifdef __arm__
+    if (run->dma)
+        bench_dma_start();
+#endif
+    for (int n = 0; n < BENCH_ITERATIONS; n++) {
+        uint32_t start = bench_cycles();
+        masked_keccak_p1600_ws(run->ws->ctx.state, NROUNDS, &run->ws->scratch);
+        run->cycles += bench_cycles() - start;
+    }
+#ifdef __arm__
+    if (run->dma)
+        bench_dma_stop();
+#endif
+}
+#endif
+
+/**
+ * CCM placement (MASKED_CCM_PLACEMENT=1): cycles per workspace permutation
+ * with the workspace in SRAM, in CCM, and in CCM with the crypto stack in
+ * CCM too. On the board each row is measured on a quiet bus and again
+ * (_dma) while DMA2 copies between two SRAM buffers without pause, which
+ * is the contention that CCM placement avoids. Each _dma row also gives, in
+ * copies, the number of 16 KiB copies that ran during the measurement and
+ * dma_buffer_address shows the copy really targets SRAM. Prints nothing
+ * without CCM placement.
+ */
+void masked_bench_ccm(void) {
+#if MASKED_CCM_PLACEMENT
+    static masked_keccak_workspace_t sram_ws;
+    static const struct {
+        const char *label;
+        int ccm;        // Workspace in CCM
+        int stack;      // Run on the CCM crypto stack
+        int dma;
+    } rows[] = {
+        { "f1600_ws_sram", 0, 0, 0 },
+        { "f1600_ws_ccm", 1, 0, 0 },
+        { "f1600_ws_ccm_crypto_stack", 1, 1, 0 },
+#ifdef __arm__
+        { "f1600_ws_sram_dma", 0, 0, 1 },
+        { "f1600_ws_ccm_dma", 1, 0, 1 },
+        { "f1600_ws_ccm_crypto_stack_dma", 1, 1, 1 },
+#endif
+    };
+    bench_ws_run_t run;
+
+#ifdef __arm__
+    bench_dma_init();
+    bench_report_value("dma_buffer_address", (unsigned long)(uintptr_t)bench_dma_buf, "addr");
+#endif
+
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++) {
+        run.ws = rows[i].ccm ? &masked_ccm_workspace : &sram_ws;
+        run.dma = rows[i].dma;
+        if (rows[i].stack)
+            masked_crypto_call(bench_ws_f1600, &run);
+        else
+            bench_ws_f1600(&run);
+        bench_report(rows[i].label, run.cycles);
+#ifdef __arm__
+        if (run.dma)
+            bench_report_value(rows[i].label, bench_dma_copies, "copies");
+#endif
+    }
+#endif
+}
+
+/**
+ * Code placement: f1600 and SHAKE128 cycles labelled with where the kernels
+ * execute from (MASKED_RAM_FUNCTIONS). Build once with 0 and once with 1 and
+ * compare the _flash and _ram rows; the address row confirms the placement.
+ */
+void masked_bench_ramfunc(void) {
+#if MASKED_RAM_FUNCTIONS
+    const char *f1600_label = "f1600_exec_ram";
+    const char *shake_label = "shake128_64B_exec_ram";
+#else
+    const char *f1600_label = "f1600_exec_flash";
+    const char *shake_label = "shake128_64B_exec_flash";
+#endif
+    static masked_uint64_t state[5][5];
+    static uint8_t msg[64], out[168];
+    uint32_t start;
+
+    bench_report_value("f1600_code_address", (unsigned long)(uintptr_t)masked_keccak_f1600, "addr");
+
+    bench_state_init(state);
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_keccak_f1600(state);
+    bench_report(f1600_label, bench_cycles() - start);
+
+    start = bench_cycles();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+        masked_shake128(out, sizeof(out), msg, sizeof(msg));
+    bench_report(shake_label, bench_cycles() - start);
+}
+
+void masked_bench_run(void) {
+    bench_cycle_counter_init();
+    printf("benchmark,masking_order,value,unit\n");
+    masked_bench_steps();
+    masked_bench_hashes();
+    masked_bench_layouts();
+    masked_bench_iota();
+    masked_bench_rng();
+    masked_bench_prefix();
+    masked_bench_turboshake();
+    masked_bench_chi();
+    masked_bench_throughput();
+    masked_bench_gadgets();
+    masked_bench_asm();
+    masked_bench_batch();
+    masked_bench_ccm();
+    masked_bench_ramfunc();
+}
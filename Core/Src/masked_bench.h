@@ -0,0 +1,84 @@
+#ifndef MASKED_BENCH_H
+#define MASKED_BENCH_H
+
+#include <stdint.h>
+
+// On-target cycle benchmarks for the masked Keccak code.
+//
+// Cycle counts come from the Cortex-M4 DWT cycle counter and are printed
+// as CSV lines over the printf/USART2 retarget. The masking order is a
+// compile-time constant, so each order (MASKING_ORDER=1..4) is a separate
+// build; every line carries the order it was measured at. The 3-share
+// threshold implementation (MASKED_TI=1) reports order 1.
+//
+// Build with -DMASKED_BENCH to run the suite from main() at start-up.
+//
+// On the host (Host/masked_bench_host.c) the same suite prints to stdout;
+// the counter is the x86 time-stamp counter, or clock_gettime()
+// nanoseconds on other CPUs, so the figures are ticks rather than cycles.
+
+// Enable and reset the DWT cycle counter (host: calibrate the stand-in).
+void bench_cycle_counter_init(void);
+
+// Current DWT cycle count.
+uint32_t bench_cycles(void);
+
+// Rate of bench_cycles() in Hz (SystemCoreClock on target).
+uint32_t bench_clock_hz(void);
+
+// Cycles per call of masked_theta, masked_rho, masked_pi, masked_chi and
+// masked_iota, of the Chi randomness (25 fill_random_matrix calls), one
+// reference round and masked_keccak_f1600.
+void masked_bench_steps(void);
+
+// Cycles and cycles per byte for each SHA3 / SHAKE function at message
+// sizes 0, 16, 64, 256 and 1024 bytes.
+void masked_bench_hashes(void);
+
+// Cycles per masked_keccak_f1600 for the lane-major and share-major layouts.
+void masked_bench_layouts(void);
+
+// Cycles per masked_keccak_f1600 spent in Iota: re-masking vs. share-0 constant.
+void masked_bench_iota(void);
+
+// Cycles per random word (TRNG vs. PRG) and SHA3-256 hashes per second
+// with the randomness source selected by MASKED_RNG_PRG.
+void masked_bench_rng(void);
+
+// Cycles per Kyber-style XOF (34-byte seed + 2-byte index): re-absorbing
+// the seed every time vs. cloning an absorbed-seed snapshot.
+void masked_bench_prefix(void);
+
+// Cycles for Keccak-p[1600, 12] and TurboSHAKE128 / KangarooTwelve next to SHAKE128.
+void masked_bench_turboshake(void);
+
+// Chi randomness per permutation (words and cycles) for the ISW and
+// recycled gadgets (order 1 only), and f1600 cycles and Chi words with the
+// MASKED_CHI_GADGET selection.
+void masked_bench_chi(void);
+
+// SHAKE128 cycles per byte with the masking mode of this build (ISW,
+// recycled Chi or 3-share TI).
+void masked_bench_throughput(void);
+
+// Cycles per masked_chi() with the unrolled or generic gadgets of this build.
+void masked_bench_gadgets(void);
+
+// Assembly vs. C: mismatch count, linear layer and permutation cycles (MASKED_KECCAK_ASM builds).
+void masked_bench_asm(void);
+
+// Cycles for four messages: serial permutations / SHAKE128 vs. the x4 batch.
+void masked_bench_batch(void);
+
+// Workspace permutation cycles in SRAM vs. CCM RAM, quiet and under a
+// continuous DMA copy in SRAM (MASKED_CCM_PLACEMENT builds).
+void masked_bench_ccm(void);
+
+// f1600 / SHAKE128 cycles tagged with the code placement of this build:
+// flash execute-in-place or SRAM (MASKED_RAM_FUNCTIONS).
+void masked_bench_ramfunc(void);
+
+// Run every benchmark in this file.
+void masked_bench_run(void);
+
+#endif // MASKED_BENCH_H
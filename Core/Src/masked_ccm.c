@@ -0,0 +1,32 @@
+#include "masked_ccm.h"
+#include "params.h"
+
+masked_keccak_workspace_t masked_ccm_workspace MASKED_CCM_BSS;
+
+/**
+ * Switch the stack pointer to the top of the CCM crypto stack around one call.
+ *
+ * The caller's sp is kept in r4, which fn must preserve (AAPCS), and is
+ * restored after fn returns. _ecrypto_stack is 8-byte aligned by the
+ * linker script, as AAPCS requires at a call boundary.
+ */
+__attribute__((noinline))
+void masked_crypto_call(void (*fn)(void *), void *arg) {
+#if MASKED_CCM_PLACEMENT && defined(__arm__)
+    register void *r0 __asm("r0") = arg;
+    register void (*r1)(void *) __asm("r1") = fn;
+
+    __asm volatile(
+        "mov   r4, sp                          \n"
+        "movw  r2, #:lower16:_ecrypto_stack    \n"
+        "movt  r2, #:upper16:_ecrypto_stack    \n"
+        "mov   sp, r2                          \n"
+        "blx   r1                              \n"
+        "mov   sp, r4                          \n"
+        : "+r"(r0), "+r"(r1)
+        :
+        : "r2", "r3", "r4", "r12", "lr", "memory", "cc");
+#else
+    fn(arg);
+#endif
+}
@@ -0,0 +1,24 @@
+#ifndef MASKED_CCM_H
+#define MASKED_CCM_H
+
+#include "params.h"
+#include "sha_shake.h"
+
+// CCM RAM placement (MASKED_CCM_PLACEMENT).
+//
+// The 64 KB core-coupled memory sits on the D-bus only: no wait states and
+// no contention with USB OTG or DMA traffic on the bus matrix. With the
+// option set, the hash workspace below, the randomness pool and the PRG
+// state are linked into .ccmbss (cleared at start-up), and
+// masked_crypto_call() runs its callback on a stack carved out of CCM
+// (_Crypto_Stack_Size in the linker script). Without it, everything stays
+// in SRAM and masked_crypto_call() is a plain call.
+
+// Shared workspace for the *_ws hash calls of the main context.
+extern masked_keccak_workspace_t masked_ccm_workspace;
+
+// Run fn(arg) on the CCM crypto stack, then return to the caller's stack.
+// Interrupts taken meanwhile also stack there. Not reentrant.
+void masked_crypto_call(void (*fn)(void *), void *arg);
+
+#endif // MASKED_CCM_H
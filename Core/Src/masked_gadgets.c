@@ -1,6 +1,5 @@
 #include "masked_types.h"
 #include "global_rng.h"
-#include "stm32f4xx_hal_rng.h"
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -15,7 +14,7 @@
  *
  * @param r Output 2D matrix of random 64-bit values
  */
-void fill_random_matrix(uint64_t r[MASKING_N][MASKING_N]) {
+MASKED_RAMFUNC void fill_random_matrix(uint64_t r[MASKING_N][MASKING_N]) {
     for (size_t i = 0; i < MASKING_N; i++) {
         for (size_t j = i + 1; j < MASKING_N; j++) {
             uint64_t val = get_random64();
@@ -26,6 +25,149 @@ void fill_random_matrix(uint64_t r[MASKING_N][MASKING_N]) {
     }
 }
 
+#if MASKED_UNROLLED_GADGETS && MASKING_N >= 2 && MASKING_N <= 5
+// Fully unrolled masked_xor / masked_and for the share counts used in
+// practice. Shares are loaded into locals once, so the compiler can keep
+// them in registers; the operations and their order are exactly those of
+// the generic loops in the #else branch.
+#if MASKING_N == 2
+MASKED_RAMFUNC void masked_xor(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b) {
+    out->share[0] = a->share[0] ^ b->share[0];
+    out->share[1] = a->share[1] ^ b->share[1];
+}
+
+MASKED_RAMFUNC void masked_and(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b,
+                               const uint64_t r[MASKING_N][MASKING_N]) {
+    const uint64_t a0 = a->share[0], a1 = a->share[1];
+    const uint64_t b0 = b->share[0], b1 = b->share[1];
+    uint64_t c0 = a0 & b0, c1 = a1 & b1;
+
+    c0 ^= r[0][1];
+    c1 ^= ((a0 & b1) ^ (a1 & b0)) ^ r[0][1];
+
+    out->share[0] = c0;
+    out->share[1] = c1;
+}
+
+#elif MASKING_N == 3
+MASKED_RAMFUNC void masked_xor(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b) {
+    out->share[0] = a->share[0] ^ b->share[0];
+    out->share[1] = a->share[1] ^ b->share[1];
+    out->share[2] = a->share[2] ^ b->share[2];
+}
+
+MASKED_RAMFUNC void masked_and(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b,
+                               const uint64_t r[MASKING_N][MASKING_N]) {
+    const uint64_t a0 = a->share[0], a1 = a->share[1], a2 = a->share[2];
+    const uint64_t b0 = b->share[0], b1 = b->share[1], b2 = b->share[2];
+    uint64_t c0 = a0 & b0, c1 = a1 & b1, c2 = a2 & b2;
+
+    c0 ^= r[0][1];
+    c1 ^= ((a0 & b1) ^ (a1 & b0)) ^ r[0][1];
+    c0 ^= r[0][2];
+    c2 ^= ((a0 & b2) ^ (a2 & b0)) ^ r[0][2];
+    c1 ^= r[1][2];
+    c2 ^= ((a1 & b2) ^ (a2 & b1)) ^ r[1][2];
+
+    out->share[0] = c0;
+    out->share[1] = c1;
+    out->share[2] = c2;
+}
+
+#elif MASKING_N == 4
+MASKED_RAMFUNC void masked_xor(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b) {
+    out->share[0] = a->share[0] ^ b->share[0];
+    out->share[1] = a->share[1] ^ b->share[1];
+    out->share[2] = a->share[2] ^ b->share[2];
+    out->share[3] = a->share[3] ^ b->share[3];
+}
+
+MASKED_RAMFUNC void masked_and(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b,
+                               const uint64_t r[MASKING_N][MASKING_N]) {
+    const uint64_t a0 = a->share[0], a1 = a->share[1], a2 = a->share[2], a3 = a->share[3];
+    const uint64_t b0 = b->share[0], b1 = b->share[1], b2 = b->share[2], b3 = b->share[3];
+    uint64_t c0 = a0 & b0, c1 = a1 & b1, c2 = a2 & b2, c3 = a3 & b3;
+
+    c0 ^= r[0][1];
+    c1 ^= ((a0 & b1) ^ (a1 & b0)) ^ r[0][1];
+    c0 ^= r[0][2];
+    c2 ^= ((a0 & b2) ^ (a2 & b0)) ^ r[0][2];
+    c0 ^= r[0][3];
+    c3 ^= ((a0 & b3) ^ (a3 & b0)) ^ r[0][3];
+    c1 ^= r[1][2];
+    c2 ^= ((a1 & b2) ^ (a2 & b1)) ^ r[1][2];
+    c1 ^= r[1][3];
+    c3 ^= ((a1 & b3) ^ (a3 & b1)) ^ r[1][3];
+    c2 ^= r[2][3];
+    c3 ^= ((a2 & b3) ^ (a3 & b2)) ^ r[2][3];
+
+    out->share[0] = c0;
+    out->share[1] = c1;
+    out->share[2] = c2;
+    out->share[3] = c3;
+}
+
+#elif MASKING_N == 5
+MASKED_RAMFUNC void masked_xor(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b) {
+    out->share[0] = a->share[0] ^ b->share[0];
+    out->share[1] = a->share[1] ^ b->share[1];
+    out->share[2] = a->share[2] ^ b->share[2];
+    out->share[3] = a->share[3] ^ b->share[3];
+    out->share[4] = a->share[4] ^ b->share[4];
+}
+
+MASKED_RAMFUNC void masked_and(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b,
+                               const uint64_t r[MASKING_N][MASKING_N]) {
+    const uint64_t a0 = a->share[0], a1 = a->share[1], a2 = a->share[2], a3 = a->share[3], a4 = a->share[4];
+    const uint64_t b0 = b->share[0], b1 = b->share[1], b2 = b->share[2], b3 = b->share[3], b4 = b->share[4];
+    uint64_t c0 = a0 & b0, c1 = a1 & b1, c2 = a2 & b2, c3 = a3 & b3, c4 = a4 & b4;
+
+    c0 ^= r[0][1];
+    c1 ^= ((a0 & b1) ^ (a1 & b0)) ^ r[0][1];
+    c0 ^= r[0][2];
+    c2 ^= ((a0 & b2) ^ (a2 & b0)) ^ r[0][2];
+    c0 ^= r[0][3];
+    c3 ^= ((a0 & b3) ^ (a3 & b0)) ^ r[0][3];
+    c0 ^= r[0][4];
+    c4 ^= ((a0 & b4) ^ (a4 & b0)) ^ r[0][4];
+    c1 ^= r[1][2];
+    c2 ^= ((a1 & b2) ^ (a2 & b1)) ^ r[1][2];
+    c1 ^= r[1][3];
+    c3 ^= ((a1 & b3) ^ (a3 & b1)) ^ r[1][3];
+    c1 ^= r[1][4];
+    c4 ^= ((a1 & b4) ^ (a4 & b1)) ^ r[1][4];
+    c2 ^= r[2][3];
+    c3 ^= ((a2 & b3) ^ (a3 & b2)) ^ r[2][3];
+    c2 ^= r[2][4];
+    c4 ^= ((a2 & b4) ^ (a4 & b2)) ^ r[2][4];
+    c3 ^= r[3][4];
+    c4 ^= ((a3 & b4) ^ (a4 & b3)) ^ r[3][4];
+
+    out->share[0] = c0;
+    out->share[1] = c1;
+    out->share[2] = c2;
+    out->share[3] = c3;
+    out->share[4] = c4;
+}
+#endif
+
+#else
 /**
  * Perform masked XOR between two values.
  *
@@ -36,9 +178,9 @@ void fill_random_matrix(uint64_t r[MASKING_N][MASKING_N]) {
  * @param a First masked operand
  * @param b Second masked operand
  */
-void masked_xor(masked_uint64_t *out,
-                const masked_uint64_t *a,
-                const masked_uint64_t *b) {
+MASKED_RAMFUNC void masked_xor(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b) {
     for (size_t i = 0; i < MASKING_N; i++) {
         out->share[i] = a->share[i] ^ b->share[i];
     }
@@ -55,10 +197,10 @@ void masked_xor(masked_uint64_t *out,
  * @param b Second masked operand
  * @param r Fresh randomness matrix r[i][j] per share-pair
  */
-void masked_and(masked_uint64_t *out,
-                const masked_uint64_t *a,
-                const masked_uint64_t *b,
-                const uint64_t r[MASKING_N][MASKING_N]) {
+MASKED_RAMFUNC void masked_and(masked_uint64_t *out,
+                               const masked_uint64_t *a,
+                               const masked_uint64_t *b,
+                               const uint64_t r[MASKING_N][MASKING_N]) {
     // Step 1: Initialize with diagonal terms
     for (size_t i = 0; i < MASKING_N; i++) {
         out->share[i] = a->share[i] & b->share[i];
@@ -76,28 +218,162 @@ void masked_and(masked_uint64_t *out,
         }
     }
 }
+#endif
 
 /**
  * Perform bitwise NOT on a masked value.
  *
- * Since NOT is linear, it can be applied to each share.
- * However, due to XOR mask structure, one share must be adjusted
- * to maintain correct recombined parity.
+ * NOT is affine: inverting a single share inverts the recombined value,
+ * so only share 0 is touched and the other shares are copied.
  *
  * @param dst Output masked result
  * @param src Input masked operand
  */
-void masked_not(masked_uint64_t *dst, const masked_uint64_t *src) {
-    // Bitwise NOT of each share — safe for Boolean masking.
-    for (size_t i = 0; i < MASKING_N; ++i)
-        dst->share[i] = ~src->share[i];
-
-    // Adjust one share so that the recombined NOT is correct.
-    uint64_t orig_parity = 0, inv_parity = 0;
-    for (size_t i = 0; i < MASKING_N; ++i) {
-        orig_parity ^= src->share[i];
-        inv_parity  ^= dst->share[i];
+MASKED_RAMFUNC void masked_not(masked_uint64_t *dst, const masked_uint64_t *src) {
+    // Flipping every bit of one share flips every bit of the recombined value.
+    *dst = *src;
+    dst->share[0] = ~src->share[0];
+}
+
+/**
+ * Perform secure masked OR between two values.
+ *
+ * a | b = a ^ b ^ (a & b): one masked AND plus share-wise XORs,
+ * with the same randomness as masked_and().
+ *
+ * @param out Output masked result (must not alias a or b)
+ * @param a First masked operand
+ * @param b Second masked operand
+ * @param r Fresh randomness matrix r[i][j] per share-pair
+ */
+MASKED_RAMFUNC void masked_or(masked_uint64_t *out,
+                              const masked_uint64_t *a,
+                              const masked_uint64_t *b,
+                              const uint64_t r[MASKING_N][MASKING_N]) {
+    masked_and(out, a, b, r);
+    masked_xor(out, out, a);
+    masked_xor(out, out, b);
+}
+
+/**
+ * Re-randomise the shares of a masked value in place.
+ *
+ * Adds a fresh random sharing of zero: each share i > 0 gets a new
+ * random word that is also folded into share 0, so the recombined value
+ * is unchanged. Costs MASKING_N - 1 random words.
+ *
+ * @param x Masked value to refresh
+ */
+MASKED_RAMFUNC void masked_refresh(masked_uint64_t *x) {
+    for (size_t i = 1; i < MASKING_N; i++) {
+        uint64_t r = get_random64();
+        x->share[0] ^= r;
+        x->share[i] ^= r;
+    }
+}
+
+/**
+ * Chi row randomness, one fresh matrix per AND (the ISW/DOM budget).
+ *
+ * @param r Output matrices, r[x] for the AND of lane x
+ */
+MASKED_RAMFUNC void chi_random_isw(uint64_t r[5][MASKING_N][MASKING_N]) {
+    for (int x = 0; x < 5; x++)
+        fill_random_matrix(r[x]);
+}
+
+#if MASKING_ORDER == 1
+/**
+ * Chi row randomness, one fresh matrix recycled by all five ANDs.
+ *
+ * AND x uses the fresh matrix rotated left by 13*x bits, so within one
+ * output word every bit is masked by a different random bit. Across
+ * words it is not: bit j of out[x] and bit j + 13(x' - x) of out[x'] carry
+ * the same random bits. One probe never sees both, so the gadget is
+ * first-order secure. A second probe on the matching share of another
+ * lane cancels the shared randomness and leaves a secret-dependent
+ * combination of two slices, so it must not be used above order 1
+ * (params.h rejects that configuration).
+ *
+ * Budget: N(N-1)/2 fresh words per row instead of 5*N(N-1)/2.
+ *
+ * @param r Output matrices, r[x] for the AND of lane x
+ */
+MASKED_RAMFUNC void chi_random_recycled(uint64_t r[5][MASKING_N][MASKING_N]) {
+    fill_random_matrix(r[0]);
+
+    for (int x = 1; x < 5; x++) {
+        unsigned int n = 13 * x;
+        for (size_t i = 0; i < MASKING_N; i++)
+            for (size_t j = 0; j < MASKING_N; j++)
+                r[x][i][j] = (r[0][i][j] << n) | (r[0][i][j] >> (64 - n));
+    }
+}
+#endif
+
+MASKED_RAMFUNC void chi_row_random(uint64_t r[5][MASKING_N][MASKING_N]) {
+#if MASKED_CHI_GADGET == MASKED_CHI_RECYCLED
+    chi_random_recycled(r);
+#else
+    chi_random_isw(r);
+#endif
+}
+
+#if MASKED_TI
+// Changing-of-the-guards state: shares 1 and 2 of the five lanes of the
+// last Chi row processed (ti_chi_guard[0] = share 1, [1] = share 2).
+uint64_t ti_chi_guard[2][5] MASKED_CCM_BSS;
+
+/**
+ * Start a new guard chain with TI_CHI_GUARD_WORDS fresh random words.
+ *
+ * Called once per permutation; every Chi row after that takes its guards
+ * from the row before it, across all rounds.
+ */
+MASKED_RAMFUNC void ti_chi_guard_refresh(void) {
+    for (int i = 0; i < 2; i++)
+        for (int x = 0; x < 5; x++)
+            ti_chi_guard[i][x] = get_random64();
+}
+
+/**
+ * First-order threshold implementation of Chi on one row (3 shares),
+ * made uniform with changing of the guards (Daemen, CHES 2017).
+ *
+ * b = a ^ (~b1 & b2) is computed share-wise so that output share i uses
+ * only input shares i+1 and i+2 (non-completeness):
+ *   out^0 = a^1 ^ (~b^1 & c^1) ^ (b^1 & c^2) ^ (b^2 & c^1) ^ g^1 ^ g^2
+ *   out^1 = a^2 ^ (~b^2 & c^2) ^ (b^2 & c^0) ^ (b^0 & c^2) ^ g^2
+ *   out^2 = a^0 ^ (~b^0 & c^0) ^ (b^0 & c^1) ^ (b^1 & c^0) ^ g^1
+ * with a, b, c the lanes x, x+1, x+2 of the row and g^1, g^2 the guards
+ * of lane x. The three NOTs together flip the recombined b once and the
+ * guards cancel, so the result is unchanged.
+ *
+ * The direct sharing alone is not uniform, and without remasking the bias
+ * would build up over the rounds. The guards are shares 1 and 2 of the
+ * previous row's input, which this row then hands on to the next one.
+ * Because Chi is invertible, the map from (input shares, guards) to
+ * (output shares, new guards) is a bijection, so the output sharing stays
+ * uniform as long as the chain started from fresh guards.
+ *
+ * @param out Output row (must not alias in)
+ * @param in  Input row
+ */
+MASKED_RAMFUNC void ti_chi_row(masked_uint64_t out[5], const masked_uint64_t in[5]) {
+    for (int x = 0; x < 5; x++) {
+        const uint64_t *a = in[x].share;
+        const uint64_t *b = in[(x + 1) % 5].share;
+        const uint64_t *c = in[(x + 2) % 5].share;
+        const uint64_t g1 = ti_chi_guard[0][x], g2 = ti_chi_guard[1][x];
+
+        out[x].share[0] = a[1] ^ (~b[1] & c[1]) ^ (b[1] & c[2]) ^ (b[2] & c[1]) ^ g1 ^ g2;
+        out[x].share[1] = a[2] ^ (~b[2] & c[2]) ^ (b[2] & c[0]) ^ (b[0] & c[2]) ^ g2;
+        out[x].share[2] = a[0] ^ (~b[0] & c[0]) ^ (b[0] & c[1]) ^ (b[1] & c[0]) ^ g1;
+    }
+
+    for (int x = 0; x < 5; x++) {
+        ti_chi_guard[0][x] = in[x].share[1];
+        ti_chi_guard[1][x] = in[x].share[2];
     }
-    uint64_t delta = inv_parity ^ ~orig_parity;
-    dst->share[0] ^= delta;
 }
+#endif
@@ -3,9 +3,6 @@
 
 #include <stdint.h>
 #include "masked_types.h"
-#include "stm32f4xx_hal.h"  // For RNG
-
-extern RNG_HandleTypeDef hrng;
 
 void fill_random_matrix(uint64_t r[MASKING_N][MASKING_N]);
 
@@ -20,5 +17,52 @@ void masked_and(masked_uint64_t *out,
 
 void masked_not(masked_uint64_t *dst, const masked_uint64_t *src) ;
 
+void masked_or(masked_uint64_t *out,
+               const masked_uint64_t *a,
+               const masked_uint64_t *b,
+               const uint64_t r[MASKING_N][MASKING_N]);
+
+void masked_refresh(masked_uint64_t *x);
+
+// === Chi Randomness ===
+// r[x] is the matrix for the AND that produces lane x of a row.
+// Fresh 64-bit words per Chi row: 5 matrices (ISW) or 1 (recycled,
+// first order only).
+#define CHI_ISW_WORDS_PER_ROW       (5 * MASKING_N * (MASKING_N - 1) / 2)
+#define CHI_RECYCLED_WORDS_PER_ROW  (MASKING_N * (MASKING_N - 1) / 2)
+
+#if MASKED_CHI_GADGET == MASKED_CHI_RECYCLED
+#define CHI_WORDS_PER_ROW CHI_RECYCLED_WORDS_PER_ROW
+#else
+#define CHI_WORDS_PER_ROW CHI_ISW_WORDS_PER_ROW
+#endif
+
+// Fresh words per Keccak-f[1600]: 5 rows x 24 rounds.
+#define CHI_WORDS_PER_F1600 (5 * 24 * CHI_WORDS_PER_ROW)
+
+void chi_random_isw(uint64_t r[5][MASKING_N][MASKING_N]);
+#if MASKING_ORDER == 1
+void chi_random_recycled(uint64_t r[5][MASKING_N][MASKING_N]);
+#endif
+// The variant selected by MASKED_CHI_GADGET.
+void chi_row_random(uint64_t r[5][MASKING_N][MASKING_N]);
+
+#if MASKED_TI
+// TI mode: Chi draws no per-row randomness, only the fresh guards
+// (shares 1 and 2 of five lanes) that start each permutation's chain.
+#define TI_CHI_GUARD_WORDS 10
+#undef CHI_WORDS_PER_F1600
+#define CHI_WORDS_PER_F1600 TI_CHI_GUARD_WORDS
+
+// Guards carried from one Chi row to the next (changing of the guards).
+extern uint64_t ti_chi_guard[2][5];
+
+// Draw fresh guards; call once at the start of every permutation.
+void ti_chi_guard_refresh(void);
+
+// Uniform Chi on one row of a 3-share state, guarded by ti_chi_guard.
+void ti_chi_row(masked_uint64_t out[5], const masked_uint64_t in[5]);
+#endif
+
 #endif
 
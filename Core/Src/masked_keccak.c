@@ -1,8 +1,16 @@
 #include "masked_types.h"
 #include "masked_gadgets.h"
-#include "stm32f4xx_hal.h"
-#include "debug_log.h"
+#include "masked_keccak.h"
 #include "params.h"
+#include <stdio.h>
+#include <string.h>
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_BI32
+#include "masked_keccak_bi32.h"
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_SOA
+#include "masked_keccak_soa.h"
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_HOST_SIMD
+#include "masked_keccak_simd.h"
+#endif
 /*
  * Keccak-F[1600] — Masked Round Transformations Summary
 
@@ -24,13 +32,11 @@
 
     Iota (ι)
     Adds a round constant into lane (0,0) to break symmetry.
-    -> Applied only to one share, followed by re-masking.
+    -> Linear: XORed into share 0 only, no re-masking needed.
 
  *
  */
 
-extern RNG_HandleTypeDef hrng;
-
 
 //======Helper Methods======
 
@@ -64,22 +70,25 @@ static const uint8_t keccak_rho_offsets[5][5] = {
     { 27, 20, 39,  8, 14 }
 };
 
+//Lane order of the Pi cycle starting at lane (1,0), as index x + 5*y.
+//Following it lets Rho and Pi move every lane straight to its final position in place.
+static const uint8_t keccak_pi_cycle[24] = {
+    10,  7, 11, 17, 18,  3,  5, 16,  8, 21, 24,  4,
+    15, 23, 19, 13, 12,  2, 20, 14, 22,  9,  6,  1
+};
+
 //Performs a circular left shift (rotate-left) of a 64-bit word by n bits.
 static inline uint64_t rol64(uint64_t x, unsigned int n) {
     n %= 64;
     return (x << n) | (x >> ((64 - n) % 64));
 }
 
-void masked_value_set(masked_uint64_t *out, uint64_t value) {
+MASKED_RAMFUNC void masked_value_set(masked_uint64_t *out, uint64_t value) {
     uint64_t acc = value;
 
 
     for (int i = 0; i < MASKING_N - 1; i++) {
-        uint32_t lo = 0, hi = 0;
-        	HAL_StatusTypeDef status1 = HAL_RNG_GenerateRandomNumber(&hrng, &lo);
-           HAL_StatusTypeDef status2 = HAL_RNG_GenerateRandomNumber(&hrng, &hi);
-
-        out->share[i] = ((uint64_t)hi << 32) | lo;
+        out->share[i] = get_random64();
         acc ^= out->share[i];
     }
 
@@ -88,6 +97,24 @@ void masked_value_set(masked_uint64_t *out, uint64_t value) {
 
 //======Sponge Phases======
 
+/**
+ * Set up an empty sponge state.
+ *
+ * All shares are zero. With the lane-complementing backend the complemented
+ * lanes start as all-ones in share 0, which is the one-time transform on
+ * the way in; squeeze undoes it with keccak_lane_complement().
+ */
+void masked_keccak_state_init(masked_uint64_t state[5][5]) {
+    for (int x = 0; x < 5; x++) {
+        for (int y = 0; y < 5; y++) {
+            for (int i = 0; i < MASKING_N; i++) {
+                state[x][y].share[i] = 0;
+            }
+            state[x][y].share[0] = keccak_lane_complement(x, y);
+        }
+    }
+}
+
 /**
  * Each block of input is XORed into the state, followed by a permutation.
  * Absorbs input bytes into a masked Keccak state.
@@ -103,13 +130,7 @@ void masked_value_set(masked_uint64_t *out, uint64_t value) {
  */
 void masked_absorb(masked_uint64_t state[5][5], const uint8_t *input, size_t input_len, size_t rate) {
     // === Initialize state to zero ===
-    for (int x = 0; x < 5; x++) {
-        for (int y = 0; y < 5; y++) {
-            for (int i = 0; i < MASKING_N; i++) {
-                state[x][y].share[i] = 0;
-            }
-        }
-    }
+    masked_keccak_state_init(state);
 
     size_t offset = 0;
 
@@ -179,7 +200,8 @@ void masked_absorb(masked_uint64_t state[5][5], const uint8_t *input, size_t inp
  * Squeezes output bytes from a masked Keccak state.
  *
  * This is the final phase in sponge-based hashing or XOF like SHAKE.
- * Recombines masked lanes to extract real output bytes.
+ * Recombines each masked lane once to extract real output bytes, and writes
+ * all 8 bytes of a lane at once whenever that much output is still wanted.
  * Applies Keccak-f permutations between squeezing rounds if more output is needed.
  *
  * @param output      Buffer to receive the output
@@ -187,26 +209,36 @@ void masked_absorb(masked_uint64_t state[5][5], const uint8_t *input, size_t inp
  * @param state       5x5 masked state to squeeze from
  * @param rate        Sponge bitrate in bytes (e.g. 168 for SHAKE128)
  */
-void masked_squeeze(uint8_t *output, size_t output_len, masked_uint64_t state[5][5], size_t rate) {
+MASKED_RAMFUNC void masked_squeeze(uint8_t *output, size_t output_len, masked_uint64_t state[5][5], size_t rate) {
     size_t offset = 0;
 
     while (offset < output_len) {
-        // Pull up to ratebytes per round.
-        // This maps each byte of the output to a specific lane+byte within the state.
-        for (int i = 0; i < rate&& offset < output_len; i++) {
+        // Pull up to rate bytes per round, one lane at a time.
+        for (size_t i = 0; i < rate && offset < output_len; i += 8) {
             size_t x = (i / 8) % 5;       // X coordinate in the 5×5 grid
             size_t y = (i / 8) / 5;       // Y coordinate in the 5×5 grid
-            size_t byte_pos = i % 8;      // Byte index within the 64-bit lane
 
             // === Recombine shares ===
             // Convert the masked lane back into a real value via XOR of all shares.
-            uint64_t lane = 0;
+            uint64_t lane = keccak_lane_complement(x, y);
             for (int j = 0; j < MASKING_N; j++) {
                 lane ^= state[x][y].share[j];
             }
 
-            // Extract the correct byte from the lane.
-            output[offset++] = (lane >> (8 * byte_pos)) & 0xFF;
+            size_t n = output_len - offset;
+            if (n >= 8) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                memcpy(output + offset, &lane, 8);
+#else
+                for (int b = 0; b < 8; b++)
+                    output[offset + b] = (uint8_t)(lane >> (8 * b));
+#endif
+                offset += 8;
+            } else {
+                // Tail: extract the remaining bytes from the lane.
+                for (size_t b = 0; b < n; b++)
+                    output[offset++] = (uint8_t)(lane >> (8 * b));
+            }
         }
 
         // === If we need more output ===
@@ -217,6 +249,79 @@ void masked_squeeze(uint8_t *output, size_t output_len, masked_uint64_t state[5]
     }
 }
 
+/**
+ * Squeezes output from a masked Keccak state without leaving the masked domain.
+ *
+ * Output lane k carries output bytes 8k..8k+7 as shares, in the same
+ * little-endian order masked_squeeze() would produce. If output_len is not
+ * a multiple of 8, the unused high bytes of the last lane are cleared in
+ * every share, so the lane is still a valid sharing of the tail bytes.
+ *
+ * @param output      ceil(output_len / 8) masked lanes to receive the output
+ * @param output_len  Number of output bytes desired
+ * @param state       5x5 masked state to squeeze from
+ * @param rate        Sponge bitrate in bytes
+ */
+MASKED_RAMFUNC void masked_squeeze_lanes(masked_uint64_t *output, size_t output_len,
+                                         masked_uint64_t state[5][5], size_t rate) {
+    size_t offset = 0;
+
+    while (offset < output_len) {
+        for (size_t i = 0; i < rate && offset < output_len; i += 8) {
+            const masked_uint64_t *lane = &state[(i / 8) % 5][(i / 8) / 5];
+            size_t n = output_len - offset;
+            uint64_t keep = (n >= 8) ? ~0ULL : ((1ULL << (8 * n)) - 1);
+
+            for (int j = 0; j < MASKING_N; j++) {
+                output[offset / 8].share[j] = lane->share[j] & keep;
+            }
+            output[offset / 8].share[0] ^= keccak_lane_complement((i / 8) % 5, (i / 8) / 5) & keep;
+            offset += (n >= 8) ? 8 : n;
+        }
+
+        if (offset < output_len) {
+            masked_keccak_f1600(state);
+        }
+    }
+}
+
+/**
+ * Squeezes output as MASKING_N share-wise byte streams.
+ *
+ * XORing output[0][k] ^ ... ^ output[MASKING_N-1][k] gives output byte k.
+ *
+ * @param output      MASKING_N buffers of output_len bytes each
+ * @param output_len  Number of output bytes desired
+ * @param state       5x5 masked state to squeeze from
+ * @param rate        Sponge bitrate in bytes
+ */
+MASKED_RAMFUNC void masked_squeeze_share_bytes(uint8_t *const output[MASKING_N], size_t output_len,
+                                               masked_uint64_t state[5][5], size_t rate) {
+    size_t offset = 0;
+
+    while (offset < output_len) {
+        for (size_t i = 0; i < rate && offset < output_len; i += 8) {
+            const masked_uint64_t *lane = &state[(i / 8) % 5][(i / 8) / 5];
+            size_t n = output_len - offset;
+            if (n > 8)
+                n = 8;
+
+            for (int j = 0; j < MASKING_N; j++) {
+                uint64_t share = lane->share[j];
+                if (j == 0)
+                    share ^= keccak_lane_complement((i / 8) % 5, (i / 8) / 5);
+                for (size_t b = 0; b < n; b++)
+                    output[j][offset + b] = (uint8_t)(share >> (8 * b));
+            }
+            offset += n;
+        }
+
+        if (offset < output_len) {
+            masked_keccak_f1600(state);
+        }
+    }
+}
+
 //======Five Main Round Functions======
 
 /**
@@ -225,7 +330,7 @@ void masked_squeeze(uint8_t *output, size_t output_len, masked_uint64_t state[5]
  * Theta mixes bits across columns using masked XORs to ensure diffusion.
  * Maintains share alignment (linear operation).
  */
-void masked_theta(masked_uint64_t state[5][5]) {
+MASKED_RAMFUNC void masked_theta(masked_uint64_t state[5][5]) {
     masked_uint64_t C[5] = {0};  // Column parity
     masked_uint64_t D[5] = {0};  // Parity difference per column
 
@@ -265,7 +370,7 @@ void masked_theta(masked_uint64_t state[5][5]) {
  * Rho rotates each lane by a fixed constant offset (same across shares),
  * spreading bits to neighboring positions while preserving the mask structure.
  */
-void masked_rho(masked_uint64_t state[5][5]) {
+MASKED_RAMFUNC void masked_rho(masked_uint64_t state[5][5]) {
     // Rho rotates each lane by a constant offset to scatter bits.
     // It’s important the same rotation is applied to every share
     // so the XOR mask relationship stays valid.
@@ -286,8 +391,8 @@ void masked_rho(masked_uint64_t state[5][5]) {
  *
  * Pi rearranges lanes within the 5x5 grid using a predefined permutation.
  * All shares of a lane are moved together to preserve masking validity.
- */c
-void masked_pi(masked_uint64_t state[5][5]) {
+ */
+MASKED_RAMFUNC void masked_pi(masked_uint64_t state[5][5]) {
     masked_uint64_t tmp[5][5];
 
     // Copy the full masked state first to keep original positions.
@@ -312,9 +417,9 @@ void masked_pi(masked_uint64_t state[5][5]) {
   * Pi rearranges lanes within the 5x5 grid using a predefined permutation.
   * All shares of a lane are moved together to preserve masking validity.
   */
-void masked_chi(masked_uint64_t out[5][5],
-                const masked_uint64_t in[5][5],
-                const uint64_t r[5][5][MASKING_N][MASKING_N]) {
+MASKED_RAMFUNC void masked_chi(masked_uint64_t out[5][5],
+                               const masked_uint64_t in[5][5],
+                               const uint64_t r[5][5][MASKING_N][MASKING_N]) {
     // Chi mixes bits in each row using a non-linear expression.
     // Since AND is not linear, it’s where leakage can happen — hence the use of
     // fresh randomness and secure masked AND gadgets.
@@ -338,16 +443,28 @@ void masked_chi(masked_uint64_t out[5][5],
  * Apply the masked Iota step of Keccak.
  *
  * Injects the round constant into lane (0,0) to break symmetry.
- * Requires re-masking the result securely to maintain masking invariants.
+ * Adding a public constant is linear, so it only needs to go into one share:
+ * no recombination and no fresh randomness.
  *
  * @param state Masked state to update
  * @param rc    Round constant for this permutation round
  */
-void masked_iota(masked_uint64_t state[5][5], uint64_t rc) {
-    // Iota introduces asymmetry by injecting a round constant into lane (0,0).
-    // This breaks symmetry and helps distinguish rounds.
-    // Because we’re masking, we must re-mask the lane after applying the constant.
+MASKED_RAMFUNC void masked_iota_linear(masked_uint64_t state[5][5], uint64_t rc) {
+    // XOR of the shares picks up rc exactly once, the other shares are untouched.
+    state[0][0].share[0] ^= rc;
+}
 
+/**
+ * Apply the masked Iota step by recombining and re-masking lane (0,0).
+ *
+ * This was the original Iota. It costs (MASKING_N - 1) get_random64() calls
+ * per round and puts the unmasked lane in a register, so it is only used
+ * when MASKED_IOTA_REMASK is set, or by the benchmark for comparison.
+ *
+ * @param state Masked state to update
+ * @param rc    Round constant for this permutation round
+ */
+MASKED_RAMFUNC void masked_iota_remask(masked_uint64_t state[5][5], uint64_t rc) {
     // Step 1: Recombine to get the true value of the lane.
     uint64_t value = 0;
     for (int i = 0; i < MASKING_N; ++i)
@@ -365,13 +482,21 @@ void masked_iota(masked_uint64_t state[5][5], uint64_t rc) {
     state[0][0].share[0] = acc;
 }
 
+MASKED_RAMFUNC void masked_iota(masked_uint64_t state[5][5], uint64_t rc) {
+#if MASKED_IOTA_REMASK
+    masked_iota_remask(state, rc);
+#else
+    masked_iota_linear(state, rc);
+#endif
+}
+
 
 // Helper function (add this)
 void print_recombined_state(masked_uint64_t state[5][5], const char *label) {
     printf("== %s (Recombined) ==\n", label);
     for (int x = 0; x < 5; x++) {
         for (int y = 0; y < 5; y++) {
-            uint64_t val = 0;
+            uint64_t val = keccak_lane_complement(x, y);
             for (int i = 0; i < MASKING_N; i++) {
                 val ^= state[x][y].share[i];
             }
@@ -382,7 +507,7 @@ void print_recombined_state(masked_uint64_t state[5][5], const char *label) {
     }
 }
 
-void masked_keccak_round(masked_uint64_t S[5][5], uint64_t rc) {
+MASKED_RAMFUNC void masked_keccak_round(masked_uint64_t S[5][5], uint64_t rc) {
 
     // Theta mixes each column’s bits into its neighbors to spread information.
     // For masking, we need to preserve XOR relationships between shares here.
@@ -397,21 +522,37 @@ void masked_keccak_round(masked_uint64_t S[5][5], uint64_t rc) {
     masked_pi(S);
 
     // Chi is non-linear, and this is where leakage can happen — we need fresh randomness.
-    // One matrix of random values per lane to feed into masked ANDs.
-    uint64_t r_chi[5][5][MASKING_N][MASKING_N];
-    for (int y = 0; y < 5; ++y)
-        for (int x = 0; x < 5; ++x)
-            fill_random_matrix(r_chi[x][y]);
-
+    // One matrix of random values per lane to feed into masked ANDs,
+    // drawn row by row by the gadget selected with MASKED_CHI_GADGET.
     // We build a new state instead of modifying in place — safer and avoids weird bugs.
     masked_uint64_t chi_out[5][5];
 
+#if MASKED_TI
+    // Threshold implementation: Chi row by row, guarded by the previous row.
+    for (int y = 0; y < 5; ++y) {
+        masked_uint64_t row_in[5], row_out[5];
+        for (int x = 0; x < 5; ++x)
+            row_in[x] = S[x][y];
+        ti_chi_row(row_out, row_in);
+        for (int x = 0; x < 5; ++x)
+            chi_out[x][y] = row_out[x];
+    }
+#else
+    uint64_t r_chi[5][5][MASKING_N][MASKING_N];
+    for (int y = 0; y < 5; ++y) {
+        uint64_t r_row[5][MASKING_N][MASKING_N];
+        chi_row_random(r_row);
+        for (int x = 0; x < 5; ++x)
+            memcpy(r_chi[x][y], r_row[x], sizeof(r_row[x]));
+    }
+
     // Chi mixes rows using NOT and AND.
     // Because we’re masking, this step is the trickiest and needs careful randomness.
     masked_chi(chi_out, S, r_chi);
+#endif
 
     // Iota adds in the round constant — this breaks symmetry and keeps things unpredictable.
-    // Only touch share[0] to avoid messing up the masking.
+    // Only share[0] is touched; the constant is public so no re-masking is needed.
     masked_iota(chi_out, rc);
 
     // Move the updated state back into S so it's ready for the next round.
@@ -420,6 +561,376 @@ void masked_keccak_round(masked_uint64_t S[5][5], uint64_t rc) {
             S[x][y] = chi_out[x][y];
 }
 
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_LANE64
+/**
+ * Reference round with its buffers in the caller's workspace.
+ *
+ * Same steps as masked_keccak_round(), but Pi writes into scratch->lanes
+ * and Chi reads from there straight back into S, so neither the
+ * chi_out[5][5] copy nor the round's Chi randomness touch the stack.
+ */
+MASKED_RAMFUNC void masked_keccak_round_ws(masked_uint64_t S[5][5], uint64_t rc, masked_keccak_scratch_t *scratch) {
+    masked_theta(S);
+    masked_rho(S);
+
+    for (int x = 0; x < 5; ++x)
+        for (int y = 0; y < 5; ++y)
+            scratch->lanes[y][(2 * x + 3 * y) % 5] = S[x][y];
+
+#if MASKED_TI
+    for (int y = 0; y < 5; ++y) {
+        masked_uint64_t row_in[5], row_out[5];
+        for (int x = 0; x < 5; ++x)
+            row_in[x] = scratch->lanes[x][y];
+        ti_chi_row(row_out, row_in);
+        for (int x = 0; x < 5; ++x)
+            S[x][y] = row_out[x];
+    }
+#else
+    for (int y = 0; y < 5; ++y) {
+        chi_row_random(scratch->r_row);
+        for (int x = 0; x < 5; ++x)
+            memcpy(scratch->r_chi[x][y], scratch->r_row[x], sizeof(scratch->r_row[x]));
+    }
+    masked_chi(S, (const masked_uint64_t (*)[5])scratch->lanes, (const uint64_t (*)[5][MASKING_N][MASKING_N])scratch->r_chi);
+#endif
+
+    masked_iota(S, rc);
+}
+#endif
+
+//======Fused Round (no whole-state copies)======
+
+/**
+ * Apply masked Theta, Rho and Pi in a single in-place pass.
+ *
+ * The column parities C and the D values are computed first. The state is
+ * then walked along the Pi cycle: each lane gets its D value, is rotated by
+ * its Rho offset and is written directly into its Pi destination, which is
+ * where Chi will read it from. Only one masked lane is held in flight, so
+ * there is no tmp[5][5] copy.
+ */
+MASKED_RAMFUNC void masked_theta_rho_pi(masked_uint64_t state[5][5]) {
+    masked_uint64_t C[5], D[5];
+
+    for (int x = 0; x < 5; x++) {
+        C[x] = state[x][0];
+        for (int y = 1; y < 5; y++) {
+            masked_xor(&C[x], &C[x], &state[x][y]);
+        }
+    }
+
+    for (int x = 0; x < 5; x++) {
+        for (int i = 0; i < MASKING_N; i++) {
+            D[x].share[i] = C[(x + 4) % 5].share[i] ^ rol64(C[(x + 1) % 5].share[i], 1);
+        }
+    }
+
+    // Lane (0,0) has a zero Rho offset and is a fixed point of Pi.
+    masked_xor(&state[0][0], &state[0][0], &D[0]);
+
+    // Carry lane (1,0) around the cycle, dropping each lane into its new slot.
+    masked_uint64_t carry = state[1][0];
+    int src = 1;
+    for (int k = 0; k < 24; k++) {
+        int dst = keccak_pi_cycle[k];
+        masked_uint64_t next = state[dst % 5][dst / 5];
+        uint8_t r = keccak_rho_offsets[src % 5][src / 5];
+
+        for (int i = 0; i < MASKING_N; i++) {
+            state[dst % 5][dst / 5].share[i] = rol64(carry.share[i] ^ D[src % 5].share[i], r);
+        }
+
+        carry = next;
+        src = dst;
+    }
+}
+
+/**
+ * Apply the masked Chi step in place.
+ *
+ * Each row is copied into a 5-lane buffer before it is overwritten,
+ * so Chi no longer needs a separate chi_out[5][5] state. The row's
+ * randomness is drawn exactly as in masked_keccak_round().
+ */
+MASKED_RAMFUNC void masked_chi_inplace(masked_uint64_t state[5][5]) {
+#if MASKED_TI
+    masked_chi_inplace_ws(state, NULL);
+#else
+    uint64_t r[5][MASKING_N][MASKING_N];
+    masked_chi_inplace_ws(state, r);
+#endif
+}
+
+//Same, with the row randomness drawn into the caller's buffer r (unused in TI mode).
+MASKED_RAMFUNC void masked_chi_inplace_ws(masked_uint64_t state[5][5], uint64_t r[5][MASKING_N][MASKING_N]) {
+    for (int y = 0; y < 5; y++) {
+        masked_uint64_t row[5];
+        for (int x = 0; x < 5; x++)
+            row[x] = state[x][y];
+
+#if MASKED_TI
+        masked_uint64_t out[5];
+        (void)r;
+        ti_chi_row(out, row);
+        for (int x = 0; x < 5; x++)
+            state[x][y] = out[x];
+#else
+        chi_row_random(r);
+        for (int x = 0; x < 5; x++) {
+            masked_uint64_t t1, t2;
+
+            masked_not(&t1, &row[(x + 1) % 5]);
+            masked_and(&t2, &t1, &row[(x + 2) % 5], r[x]);
+            masked_xor(&state[x][y], &row[x], &t2);
+        }
+#endif
+    }
+}
+
+MASKED_RAMFUNC void masked_keccak_round_fused(masked_uint64_t S[5][5], uint64_t rc) {
+    masked_theta_rho_pi(S);
+    masked_chi_inplace(S);
+    masked_iota(S, rc);
+}
+
+//======Lane-Complementing Round======
+
+// Chi in the lane-complementing representation, per row y and lane x:
+//   out[x] = in[x] ^ (in[x+1] OP in[x+2]) with OP = AND or OR and some
+//   operands inverted. Bits: LC_OR selects OR, LC_N1 / LC_N2 invert the
+//   first / second operand, LC_NS inverts in[x] itself.
+#define LC_OR 1
+#define LC_N1 2
+#define LC_N2 4
+#define LC_NS 8
+
+static const uint8_t keccak_lc_chi[5][5] = {
+    { LC_OR, LC_OR | LC_N1, 0,             LC_OR,         0     },
+    { LC_OR, 0,             LC_OR | LC_N2, LC_OR,         0     },
+    { LC_OR, 0,             LC_N1,         LC_OR | LC_NS, 0     },
+    { 0,     LC_OR,         LC_OR | LC_N1, LC_NS,         LC_OR },
+    { LC_N1, LC_OR | LC_NS, 0,             LC_OR,         0     },
+};
+
+/**
+ * Apply the masked Chi step in place on a lane-complemented state.
+ *
+ * The six complemented lanes are chosen so that, after Theta, Rho and Pi,
+ * every row can be computed with ANDs and ORs and only one inverted lane
+ * per row (5 masked NOTs per round instead of 25). The output has the
+ * same lanes complemented as the input. A masked OR costs one masked AND
+ * plus XORs, so the randomness per row is unchanged.
+ */
+MASKED_RAMFUNC void masked_chi_lanecomp(masked_uint64_t state[5][5]) {
+    uint64_t r[5][MASKING_N][MASKING_N];
+    masked_chi_lanecomp_ws(state, r);
+}
+
+//Same, with the row randomness drawn into the caller's buffer r.
+MASKED_RAMFUNC void masked_chi_lanecomp_ws(masked_uint64_t state[5][5], uint64_t r[5][MASKING_N][MASKING_N]) {
+    for (int y = 0; y < 5; y++) {
+        masked_uint64_t row[5];
+        for (int x = 0; x < 5; x++)
+            row[x] = state[x][y];
+
+        chi_row_random(r);
+        for (int x = 0; x < 5; x++) {
+            uint8_t op = keccak_lc_chi[y][x];
+            masked_uint64_t a = row[x], b = row[(x + 1) % 5], c = row[(x + 2) % 5], t;
+
+            if (op & LC_N1)
+                masked_not(&b, &b);
+            if (op & LC_N2)
+                masked_not(&c, &c);
+            if (op & LC_NS)
+                masked_not(&a, &a);
+
+            if (op & LC_OR)
+                masked_or(&t, &b, &c, r[x]);
+            else
+                masked_and(&t, &b, &c, r[x]);
+            masked_xor(&state[x][y], &a, &t);
+        }
+    }
+}
+
+MASKED_RAMFUNC void masked_keccak_round_lanecomp(masked_uint64_t S[5][5], uint64_t rc) {
+    masked_theta_rho_pi(S);
+    masked_chi_lanecomp(S);
+    masked_iota(S, rc);
+}
+
+//======Batched Round (x4 / x8)======
+
+/**
+ * Keccak-p[1600, nrounds] on count independent states in lock-step.
+ *
+ * Theta, Rho and Pi run with the instance loop innermost, so the M4 sees
+ * count independent dependency chains back to back instead of one long
+ * chain, and the round loop, the Pi walk and the round constant are
+ * shared by all instances. Chi keeps its per-instance row randomness:
+ * masks are never shared between instances, which may hash related
+ * secrets, so the random word count per instance is unchanged.
+ *
+ * Inlined with a constant count by the x4 / x8 wrappers.
+ */
+static inline __attribute__((always_inline))
+void masked_keccak_p1600_batch(masked_uint64_t (*state)[5][5], int count, int nrounds) {
+    masked_uint64_t C[MASKED_KECCAK_BATCH_MAX][5], D[MASKED_KECCAK_BATCH_MAX][5];
+    masked_uint64_t carry[MASKED_KECCAK_BATCH_MAX];
+
+#if MASKED_TI
+    // One guard chain runs through the Chi rows of all instances.
+    ti_chi_guard_refresh();
+#endif
+    for (int round = 24 - nrounds; round < 24; round++) {
+        // Theta
+        for (int x = 0; x < 5; x++)
+            for (int n = 0; n < count; n++)
+                for (int i = 0; i < MASKING_N; i++)
+                    C[n][x].share[i] = state[n][x][0].share[i] ^ state[n][x][1].share[i] ^
+                                       state[n][x][2].share[i] ^ state[n][x][3].share[i] ^
+                                       state[n][x][4].share[i];
+
+        for (int x = 0; x < 5; x++)
+            for (int n = 0; n < count; n++)
+                for (int i = 0; i < MASKING_N; i++)
+                    D[n][x].share[i] = C[n][(x + 4) % 5].share[i] ^ rol64(C[n][(x + 1) % 5].share[i], 1);
+
+        // Rho + Pi along the Pi cycle, as in masked_theta_rho_pi()
+        for (int n = 0; n < count; n++) {
+            for (int i = 0; i < MASKING_N; i++)
+                state[n][0][0].share[i] ^= D[n][0].share[i];
+            carry[n] = state[n][1][0];
+        }
+
+        int src = 1;
+        for (int k = 0; k < 24; k++) {
+            int dst = keccak_pi_cycle[k];
+            uint8_t r = keccak_rho_offsets[src % 5][src / 5];
+
+            for (int n = 0; n < count; n++) {
+                masked_uint64_t next = state[n][dst % 5][dst / 5];
+                for (int i = 0; i < MASKING_N; i++)
+                    state[n][dst % 5][dst / 5].share[i] = rol64(carry[n].share[i] ^ D[n][src % 5].share[i], r);
+                carry[n] = next;
+            }
+            src = dst;
+        }
+
+        // Chi + Iota
+        for (int n = 0; n < count; n++) {
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_LANECOMP
+            masked_chi_lanecomp(state[n]);
+#else
+            masked_chi_inplace(state[n]);
+#endif
+            masked_iota(state[n], RC[round]);
+        }
+    }
+}
+
+/**
+ * Keccak-p[1600, nrounds] on four / eight independent masked states.
+ *
+ * Every state is in the representation of this build (see
+ * masked_keccak_state_init()) and ends up exactly as after
+ * masked_keccak_p1600(). KECCAK_BACKEND_HOST_SIMD runs the instances in
+ * the elements of one vector per share; every other backend uses the
+ * lock-step C round above.
+ */
+MASKED_RAMFUNC void masked_keccak_p1600_x4(masked_uint64_t state[4][5][5], int nrounds) {
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_HOST_SIMD
+    masked_keccak_p1600_simd_x4(state, nrounds);
+#else
+    masked_keccak_p1600_batch(state, 4, nrounds);
+#endif
+}
+
+MASKED_RAMFUNC void masked_keccak_p1600_x8(masked_uint64_t state[8][5][5], int nrounds) {
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_HOST_SIMD
+    masked_keccak_p1600_simd_x8(state, nrounds);
+#else
+    masked_keccak_p1600_batch(state, 8, nrounds);
+#endif
+}
+
+/**
+ * Perform the reduced-round Keccak-p[1600, nrounds] permutation on a masked state.
+ *
+ * Keccak-p with n_r rounds is the last n_r rounds of Keccak-f[1600], so the
+ * round constants start at RC[24 - nrounds]. nrounds = 12 is the permutation
+ * of TurboSHAKE and KangarooTwelve.
+ *
+ * state is the 5×5 masked Keccak state, nrounds is 1..24.
+ * The backend is chosen at build time with MASKED_KECCAK_BACKEND (see params.h).
+ */
+MASKED_RAMFUNC void masked_keccak_p1600(masked_uint64_t state[5][5], int nrounds) {
+#if MASKED_TI
+    ti_chi_guard_refresh();
+#endif
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_BI32
+    masked_keccak_p1600_bi32(state, nrounds);
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_SOA
+    masked_keccak_p1600_soa(state, nrounds);
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_FUSED
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_keccak_round_fused(state, RC[i]);
+    }
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_LANECOMP
+    // The state is already in complemented form (masked_keccak_state_init).
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_keccak_round_lanecomp(state, RC[i]);
+    }
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_HOST_SIMD
+    masked_keccak_p1600_simd(state, nrounds);
+#else
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_keccak_round(state, RC[i]);
+    }
+#endif
+}
+
+/**
+ * Keccak-p[1600, nrounds] with every large buffer in the caller's scratch.
+ *
+ * Same result as masked_keccak_p1600(). The Chi randomness, the reference
+ * round's lane buffer and the BI32 / SOA state copy live in scratch, so
+ * the stack only holds a row of lanes and a few loop variables and the
+ * bound shows up as a small fixed frame in the -fstack-usage output. The
+ * host SIMD backend keeps its vectors in registers and on the stack.
+ */
+MASKED_RAMFUNC void masked_keccak_p1600_ws(masked_uint64_t state[5][5], int nrounds, masked_keccak_scratch_t *scratch) {
+#if MASKED_TI
+    ti_chi_guard_refresh();
+#endif
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_BI32
+    masked_keccak_p1600_bi32_ws(state, nrounds, scratch->bi32, scratch->r_row);
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_SOA
+    masked_keccak_p1600_soa_ws(state, nrounds, &scratch->soa, scratch->r_row);
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_FUSED
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_theta_rho_pi(state);
+        masked_chi_inplace_ws(state, scratch->r_row);
+        masked_iota(state, RC[i]);
+    }
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_LANECOMP
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_theta_rho_pi(state);
+        masked_chi_lanecomp_ws(state, scratch->r_row);
+        masked_iota(state, RC[i]);
+    }
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_HOST_SIMD
+    (void)scratch;
+    masked_keccak_p1600_simd(state, nrounds);
+#else
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_keccak_round_ws(state, RC[i], scratch);
+    }
+#endif
+}
+
 /**
  * Perform the full Keccak-f[1600] permutation on a masked state.
  *
@@ -428,8 +939,6 @@ void masked_keccak_round(masked_uint64_t S[5][5], uint64_t rc) {
  *
  * state is the 5×5 masked Keccak state.
  */
-void masked_keccak_f1600(masked_uint64_t state[5][5]) {
-    for (int i = 0; i < 24; i++) {
-        masked_keccak_round(state, RC[i]);
-    }
+MASKED_RAMFUNC void masked_keccak_f1600(masked_uint64_t state[5][5]) {
+    masked_keccak_p1600(state, NROUNDS);
 }
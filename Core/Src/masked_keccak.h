@@ -4,6 +4,14 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "masked_types.h"
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_BI32
+#include "masked_keccak_bi32.h"
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_SOA
+#include "masked_keccak_soa.h"
+#endif
+
+// Iota round constants, shared by every permutation backend
+extern const uint64_t RC[24];
 
 // === Round Functions ===
 void masked_theta(masked_uint64_t state[5][5]);
@@ -12,14 +20,85 @@ void masked_pi(masked_uint64_t state[5][5]);
 void masked_chi(masked_uint64_t out[5][5], const masked_uint64_t in[5][5],
                 const uint64_t r[5][5][MASKING_N][MASKING_N]);
 void masked_iota(masked_uint64_t state[5][5], uint64_t rc);
+void masked_iota_linear(masked_uint64_t state[5][5], uint64_t rc);
+void masked_iota_remask(masked_uint64_t state[5][5], uint64_t rc);
 void masked_keccak_round(masked_uint64_t state[5][5], uint64_t rc);
 
+// === Caller-Provided Scratch ===
+// Every buffer a permutation would otherwise put on the stack: the Chi
+// randomness, the reference round's Pi output and the BI32 / SOA copy of
+// the state. Allocate it statically (or inside a masked_keccak_workspace_t)
+// and pass it to masked_keccak_p1600_ws(). Only the buffers of the
+// selected backend are present.
+typedef struct masked_keccak_scratch {
+    uint64_t r_row[5][MASKING_N][MASKING_N];        // Chi randomness of one row
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_LANE64
+#if !MASKED_TI
+    uint64_t r_chi[5][5][MASKING_N][MASKING_N];     // Chi randomness of one round
+#endif
+    masked_uint64_t lanes[5][5];                    // Pi output read by Chi
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_BI32
+    masked_bi32_lane_t bi32[5][5];                  // Interleaved state
+#elif MASKED_KECCAK_BACKEND == KECCAK_BACKEND_SOA
+    masked_soa_state_t soa;                         // Share-major state
+#endif
+} __attribute__((aligned(8))) masked_keccak_scratch_t;
+
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_LANE64
+// Reference round with its buffers in scratch (the other backends have their own).
+void masked_keccak_round_ws(masked_uint64_t state[5][5], uint64_t rc, masked_keccak_scratch_t *scratch);
+#endif
+
+// === Fused Round (in place, no whole-state copies) ===
+void masked_theta_rho_pi(masked_uint64_t state[5][5]);
+void masked_chi_inplace(masked_uint64_t state[5][5]);
+void masked_chi_inplace_ws(masked_uint64_t state[5][5], uint64_t r[5][MASKING_N][MASKING_N]);
+void masked_keccak_round_fused(masked_uint64_t state[5][5], uint64_t rc);
+
+// === Lane-Complementing Round (KECCAK_BACKEND_LANECOMP) ===
+// The state is kept with lanes (1,0), (2,0), (3,1), (2,2), (2,3), (0,4)
+// complemented for the whole sponge; Chi then needs 5 NOTs per round.
+void masked_chi_lanecomp(masked_uint64_t state[5][5]);
+void masked_chi_lanecomp_ws(masked_uint64_t state[5][5], uint64_t r[5][MASKING_N][MASKING_N]);
+void masked_keccak_round_lanecomp(masked_uint64_t state[5][5], uint64_t rc);
+
+// All-ones if lane (x, y) is stored complemented by this build, else 0.
+// Squeeze XORs it into the recombined lane (or share 0) to undo the transform.
+static inline uint64_t keccak_lane_complement(size_t x, size_t y) {
+#if MASKED_KECCAK_BACKEND == KECCAK_BACKEND_LANECOMP
+    size_t i = x + 5 * y;
+    return (i == 1 || i == 2 || i == 8 || i == 12 || i == 17 || i == 20) ? ~0ULL : 0;
+#else
+    (void)x;
+    (void)y;
+    return 0;
+#endif
+}
+
+// Empty sponge state (all zero, complemented lanes applied if any).
+void masked_keccak_state_init(masked_uint64_t state[5][5]);
+
 // === Sponge Construction ===
 void masked_absorb(masked_uint64_t state[5][5], const uint8_t *input, size_t input_len, size_t rate);
 void masked_squeeze(uint8_t *output, size_t output_len, masked_uint64_t state[5][5], size_t rate);
+void masked_squeeze_lanes(masked_uint64_t *output, size_t output_len,
+                          masked_uint64_t state[5][5], size_t rate);
+void masked_squeeze_share_bytes(uint8_t *const output[MASKING_N], size_t output_len,
+                                masked_uint64_t state[5][5], size_t rate);
 
 // === Permutation Wrapper ===
 void masked_keccak_f1600(masked_uint64_t state[5][5]);
+// Last nrounds rounds of Keccak-f[1600] (Keccak-p[1600, nrounds]).
+void masked_keccak_p1600(masked_uint64_t state[5][5], int nrounds);
+// Same, with all large buffers in the caller's scratch (bounded stack).
+void masked_keccak_p1600_ws(masked_uint64_t state[5][5], int nrounds, masked_keccak_scratch_t *scratch);
+
+// === Batched Permutation ===
+// Keccak-p[1600, nrounds] on 4 or 8 independent states in lock-step;
+// state[n] ends up exactly as masked_keccak_p1600(state[n], nrounds).
+#define MASKED_KECCAK_BATCH_MAX 8
+void masked_keccak_p1600_x4(masked_uint64_t state[4][5][5], int nrounds);
+void masked_keccak_p1600_x8(masked_uint64_t state[8][5][5], int nrounds);
 
 // === Hash Function Interfaces ===
 void masked_sha3_256(uint8_t *output, const uint8_t *input, size_t input_len);
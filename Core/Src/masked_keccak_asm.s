@@ -0,0 +1,882 @@
+/*
+ * Masked Keccak-p[1600] round kernel for the share-major backend, Thumb-2.
+ *
+ * void keccak_linear_layer_asm(uint64_t A[25]);
+ *
+ * Same function as keccak_linear_layer() in masked_keccak_soa.c: the
+ * share-major backend calls it once per share, so it serves every masking
+ * order. Lanes are indexed x + 5*y, little-endian (low word first).
+ *
+ * Fully unrolled, no tables: every 64-bit rotation is two shifted ORRs
+ * per half through the barrel shifter, and Theta XORs D[x] into its column
+ * as soon as it is formed. Only C[5] goes to the stack.
+ *
+ * For 2 to 4 shares (MASKING_ORDER 1 to 3) the file also has the masked
+ * Chi row and the unrolled permutation around it, further down.
+ *
+ * Selected with MASKED_KECCAK_ASM=1 (params.h); the options in params.h
+ * must be given to the assembler as well as to the compiler. Cross-checked
+ * against the C round by masked_soa_keccak_asm_check() at start-up.
+ */
+
+#include "params.h"
+
+    .syntax unified
+    .cpu cortex-m4
+    .thumb
+
+    .section .text.keccak_linear_layer_asm,"ax",%progbits
+    .align 2
+    .global keccak_linear_layer_asm
+    .thumb_func
+    .type keccak_linear_layer_asm, %function
+keccak_linear_layer_asm:
+    push    {r4-r7}
+    sub     sp, sp, #40
+    @ Theta: C[x] = A[x] ^ A[x+5] ^ A[x+10] ^ A[x+15] ^ A[x+20], kept on the stack
+    ldrd    r2, r3, [r0, #0]
+    ldrd    r4, r5, [r0, #40]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #80]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #120]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #160]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    strd    r2, r3, [sp, #0]
+    ldrd    r2, r3, [r0, #8]
+    ldrd    r4, r5, [r0, #48]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #88]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #128]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #168]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    strd    r2, r3, [sp, #8]
+    ldrd    r2, r3, [r0, #16]
+    ldrd    r4, r5, [r0, #56]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #96]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #136]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #176]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    strd    r2, r3, [sp, #16]
+    ldrd    r2, r3, [r0, #24]
+    ldrd    r4, r5, [r0, #64]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #104]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #144]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #184]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    strd    r2, r3, [sp, #24]
+    ldrd    r2, r3, [r0, #32]
+    ldrd    r4, r5, [r0, #72]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #112]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #152]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    ldrd    r4, r5, [r0, #192]
+    eor     r2, r2, r4
+    eor     r3, r3, r5
+    strd    r2, r3, [sp, #32]
+    @ Theta: D[x] = C[x-1] ^ rol(C[x+1], 1), XORed into column x straight away
+    ldrd    r4, r5, [sp, #8]
+    ldrd    r2, r3, [sp, #32]
+    eor     r2, r2, r4, lsl #1
+    eor     r2, r2, r5, lsr #31
+    eor     r3, r3, r5, lsl #1
+    eor     r3, r3, r4, lsr #31
+    ldrd    r6, r7, [r0, #0]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #0]
+    ldrd    r6, r7, [r0, #40]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #40]
+    ldrd    r6, r7, [r0, #80]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #80]
+    ldrd    r6, r7, [r0, #120]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #120]
+    ldrd    r6, r7, [r0, #160]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #160]
+    ldrd    r4, r5, [sp, #16]
+    ldrd    r2, r3, [sp, #0]
+    eor     r2, r2, r4, lsl #1
+    eor     r2, r2, r5, lsr #31
+    eor     r3, r3, r5, lsl #1
+    eor     r3, r3, r4, lsr #31
+    ldrd    r6, r7, [r0, #8]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #8]
+    ldrd    r6, r7, [r0, #48]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #48]
+    ldrd    r6, r7, [r0, #88]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #88]
+    ldrd    r6, r7, [r0, #128]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #128]
+    ldrd    r6, r7, [r0, #168]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #168]
+    ldrd    r4, r5, [sp, #24]
+    ldrd    r2, r3, [sp, #8]
+    eor     r2, r2, r4, lsl #1
+    eor     r2, r2, r5, lsr #31
+    eor     r3, r3, r5, lsl #1
+    eor     r3, r3, r4, lsr #31
+    ldrd    r6, r7, [r0, #16]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #16]
+    ldrd    r6, r7, [r0, #56]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #56]
+    ldrd    r6, r7, [r0, #96]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #96]
+    ldrd    r6, r7, [r0, #136]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #136]
+    ldrd    r6, r7, [r0, #176]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #176]
+    ldrd    r4, r5, [sp, #32]
+    ldrd    r2, r3, [sp, #16]
+    eor     r2, r2, r4, lsl #1
+    eor     r2, r2, r5, lsr #31
+    eor     r3, r3, r5, lsl #1
+    eor     r3, r3, r4, lsr #31
+    ldrd    r6, r7, [r0, #24]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #24]
+    ldrd    r6, r7, [r0, #64]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #64]
+    ldrd    r6, r7, [r0, #104]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #104]
+    ldrd    r6, r7, [r0, #144]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #144]
+    ldrd    r6, r7, [r0, #184]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #184]
+    ldrd    r4, r5, [sp, #0]
+    ldrd    r2, r3, [sp, #24]
+    eor     r2, r2, r4, lsl #1
+    eor     r2, r2, r5, lsr #31
+    eor     r3, r3, r5, lsl #1
+    eor     r3, r3, r4, lsr #31
+    ldrd    r6, r7, [r0, #32]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #32]
+    ldrd    r6, r7, [r0, #72]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #72]
+    ldrd    r6, r7, [r0, #112]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #112]
+    ldrd    r6, r7, [r0, #152]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #152]
+    ldrd    r6, r7, [r0, #192]
+    eor     r6, r6, r2
+    eor     r7, r7, r3
+    strd    r6, r7, [r0, #192]
+    @ Rho + Pi: walk the Pi cycle from lane 1, rotating the carried lane into its slot
+    ldrd    r2, r3, [r0, #8]
+    ldrd    r4, r5, [r0, #80]
+    @ A[10] = rol64(carry, 1)
+    lsl     r6, r2, #1
+    orr     r6, r6, r3, lsr #31
+    lsl     r7, r3, #1
+    orr     r7, r7, r2, lsr #31
+    strd    r6, r7, [r0, #80]
+    ldrd    r2, r3, [r0, #56]
+    @ A[7] = rol64(carry, 3)
+    lsl     r6, r4, #3
+    orr     r6, r6, r5, lsr #29
+    lsl     r7, r5, #3
+    orr     r7, r7, r4, lsr #29
+    strd    r6, r7, [r0, #56]
+    ldrd    r4, r5, [r0, #88]
+    @ A[11] = rol64(carry, 6)
+    lsl     r6, r2, #6
+    orr     r6, r6, r3, lsr #26
+    lsl     r7, r3, #6
+    orr     r7, r7, r2, lsr #26
+    strd    r6, r7, [r0, #88]
+    ldrd    r2, r3, [r0, #136]
+    @ A[17] = rol64(carry, 10)
+    lsl     r6, r4, #10
+    orr     r6, r6, r5, lsr #22
+    lsl     r7, r5, #10
+    orr     r7, r7, r4, lsr #22
+    strd    r6, r7, [r0, #136]
+    ldrd    r4, r5, [r0, #144]
+    @ A[18] = rol64(carry, 15)
+    lsl     r6, r2, #15
+    orr     r6, r6, r3, lsr #17
+    lsl     r7, r3, #15
+    orr     r7, r7, r2, lsr #17
+    strd    r6, r7, [r0, #144]
+    ldrd    r2, r3, [r0, #24]
+    @ A[3] = rol64(carry, 21)
+    lsl     r6, r4, #21
+    orr     r6, r6, r5, lsr #11
+    lsl     r7, r5, #21
+    orr     r7, r7, r4, lsr #11
+    strd    r6, r7, [r0, #24]
+    ldrd    r4, r5, [r0, #40]
+    @ A[5] = rol64(carry, 28)
+    lsl     r6, r2, #28
+    orr     r6, r6, r3, lsr #4
+    lsl     r7, r3, #28
+    orr     r7, r7, r2, lsr #4
+    strd    r6, r7, [r0, #40]
+    ldrd    r2, r3, [r0, #128]
+    @ A[16] = rol64(carry, 36)
+    lsl     r6, r5, #4
+    orr     r6, r6, r4, lsr #28
+    lsl     r7, r4, #4
+    orr     r7, r7, r5, lsr #28
+    strd    r6, r7, [r0, #128]
+    ldrd    r4, r5, [r0, #64]
+    @ A[8] = rol64(carry, 45)
+    lsl     r6, r3, #13
+    orr     r6, r6, r2, lsr #19
+    lsl     r7, r2, #13
+    orr     r7, r7, r3, lsr #19
+    strd    r6, r7, [r0, #64]
+    ldrd    r2, r3, [r0, #168]
+    @ A[21] = rol64(carry, 55)
+    lsl     r6, r5, #23
+    orr     r6, r6, r4, lsr #9
+    lsl     r7, r4, #23
+    orr     r7, r7, r5, lsr #9
+    strd    r6, r7, [r0, #168]
+    ldrd    r4, r5, [r0, #192]
+    @ A[24] = rol64(carry, 2)
+    lsl     r6, r2, #2
+    orr     r6, r6, r3, lsr #30
+    lsl     r7, r3, #2
+    orr     r7, r7, r2, lsr #30
+    strd    r6, r7, [r0, #192]
+    ldrd    r2, r3, [r0, #32]
+    @ A[4] = rol64(carry, 14)
+    lsl     r6, r4, #14
+    orr     r6, r6, r5, lsr #18
+    lsl     r7, r5, #14
+    orr     r7, r7, r4, lsr #18
+    strd    r6, r7, [r0, #32]
+    ldrd    r4, r5, [r0, #120]
+    @ A[15] = rol64(carry, 27)
+    lsl     r6, r2, #27
+    orr     r6, r6, r3, lsr #5
+    lsl     r7, r3, #27
+    orr     r7, r7, r2, lsr #5
+    strd    r6, r7, [r0, #120]
+    ldrd    r2, r3, [r0, #184]
+    @ A[23] = rol64(carry, 41)
+    lsl     r6, r5, #9
+    orr     r6, r6, r4, lsr #23
+    lsl     r7, r4, #9
+    orr     r7, r7, r5, lsr #23
+    strd    r6, r7, [r0, #184]
+    ldrd    r4, r5, [r0, #152]
+    @ A[19] = rol64(carry, 56)
+    lsl     r6, r3, #24
+    orr     r6, r6, r2, lsr #8
+    lsl     r7, r2, #24
+    orr     r7, r7, r3, lsr #8
+    strd    r6, r7, [r0, #152]
+    ldrd    r2, r3, [r0, #104]
+    @ A[13] = rol64(carry, 8)
+    lsl     r6, r4, #8
+    orr     r6, r6, r5, lsr #24
+    lsl     r7, r5, #8
+    orr     r7, r7, r4, lsr #24
+    strd    r6, r7, [r0, #104]
+    ldrd    r4, r5, [r0, #96]
+    @ A[12] = rol64(carry, 25)
+    lsl     r6, r2, #25
+    orr     r6, r6, r3, lsr #7
+    lsl     r7, r3, #25
+    orr     r7, r7, r2, lsr #7
+    strd    r6, r7, [r0, #96]
+    ldrd    r2, r3, [r0, #16]
+    @ A[2] = rol64(carry, 43)
+    lsl     r6, r5, #11
+    orr     r6, r6, r4, lsr #21
+    lsl     r7, r4, #11
+    orr     r7, r7, r5, lsr #21
+    strd    r6, r7, [r0, #16]
+    ldrd    r4, r5, [r0, #160]
+    @ A[20] = rol64(carry, 62)
+    lsl     r6, r3, #30
+    orr     r6, r6, r2, lsr #2
+    lsl     r7, r2, #30
+    orr     r7, r7, r3, lsr #2
+    strd    r6, r7, [r0, #160]
+    ldrd    r2, r3, [r0, #112]
+    @ A[14] = rol64(carry, 18)
+    lsl     r6, r4, #18
+    orr     r6, r6, r5, lsr #14
+    lsl     r7, r5, #18
+    orr     r7, r7, r4, lsr #14
+    strd    r6, r7, [r0, #112]
+    ldrd    r4, r5, [r0, #176]
+    @ A[22] = rol64(carry, 39)
+    lsl     r6, r3, #7
+    orr     r6, r6, r2, lsr #25
+    lsl     r7, r2, #7
+    orr     r7, r7, r3, lsr #25
+    strd    r6, r7, [r0, #176]
+    ldrd    r2, r3, [r0, #72]
+    @ A[9] = rol64(carry, 61)
+    lsl     r6, r5, #29
+    orr     r6, r6, r4, lsr #3
+    lsl     r7, r4, #29
+    orr     r7, r7, r5, lsr #3
+    strd    r6, r7, [r0, #72]
+    ldrd    r4, r5, [r0, #48]
+    @ A[6] = rol64(carry, 20)
+    lsl     r6, r2, #20
+    orr     r6, r6, r3, lsr #12
+    lsl     r7, r3, #20
+    orr     r7, r7, r2, lsr #12
+    strd    r6, r7, [r0, #48]
+    ldrd    r2, r3, [r0, #8]
+    @ A[1] = rol64(carry, 44)
+    lsl     r6, r5, #12
+    orr     r6, r6, r4, lsr #20
+    lsl     r7, r4, #12
+    orr     r7, r7, r5, lsr #20
+    strd    r6, r7, [r0, #8]
+    add     sp, sp, #40
+    pop     {r4-r7}
+    bx      lr
+    .size keccak_linear_layer_asm, .-keccak_linear_layer_asm
+
+#if MASKING_N >= 2 && MASKING_N <= 4
+/*
+ * Masked Chi on one row of the share-major state, ISW AND as in masked_and().
+ *
+ * void masked_soa_chi_row_asm(uint64_t *row, const uint64_t r[5][MASKING_N][MASKING_N]);
+ *
+ * row points at lane (0, y) of share 0; share i of lane x is row[25*i + x].
+ * r is the row randomness from chi_row_random(). Chi works bit by bit, so
+ * the low and the high words of the row are done one after the other:
+ * each half of the input row is copied to the stack, then every output
+ * share is built in registers in the order of masked_and() and
+ * masked_xor() and written back over the state.
+ */
+#if MASKING_N == 2
+    .macro chi_lane x, b, c, h
+    @ shares of lanes x+1 (b) and x+2 (c) from the copy; share 0 of b stays
+    @ uncomplemented, BIC applies the NOT
+    ldr     r2, [sp, #(0 + \b * 4)]
+    ldr     r3, [sp, #(20 + \b * 4)]
+    ldr     r6, [sp, #(0 + \c * 4)]
+    ldr     r7, [sp, #(20 + \c * 4)]
+    @ share 0
+    bic     r10, r6, r2
+    ldr     r11, [r1, #((\x * 4 + 1) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [sp, #(0 + \x * 4)]
+    eor     r10, r10, r11
+    str     r10, [r0, #(0 + \x * 8 + \h)]
+    @ share 1
+    and     r10, r3, r7
+    bic     r11, r7, r2
+    and     r12, r3, r6
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 4 + 1) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    ldr     r11, [sp, #(20 + \x * 4)]
+    eor     r10, r10, r11
+    str     r10, [r0, #(200 + \x * 8 + \h)]
+    .endm
+#elif MASKING_N == 3
+    .macro chi_lane x, b, c, h
+    @ shares of lanes x+1 (b) and x+2 (c) from the copy; share 0 of b stays
+    @ uncomplemented, BIC applies the NOT
+    ldr     r2, [sp, #(0 + \b * 4)]
+    ldr     r3, [sp, #(20 + \b * 4)]
+    ldr     r4, [sp, #(40 + \b * 4)]
+    ldr     r6, [sp, #(0 + \c * 4)]
+    ldr     r7, [sp, #(20 + \c * 4)]
+    ldr     r8, [sp, #(40 + \c * 4)]
+    @ share 0
+    bic     r10, r6, r2
+    ldr     r11, [r1, #((\x * 9 + 1) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [r1, #((\x * 9 + 2) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [sp, #(0 + \x * 4)]
+    eor     r10, r10, r11
+    str     r10, [r0, #(0 + \x * 8 + \h)]
+    @ share 1
+    and     r10, r3, r7
+    bic     r11, r7, r2
+    and     r12, r3, r6
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 9 + 1) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    ldr     r11, [r1, #((\x * 9 + 5) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [sp, #(20 + \x * 4)]
+    eor     r10, r10, r11
+    str     r10, [r0, #(200 + \x * 8 + \h)]
+    @ share 2
+    and     r10, r4, r8
+    bic     r11, r8, r2
+    and     r12, r4, r6
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 9 + 2) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    and     r11, r3, r8
+    and     r12, r4, r7
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 9 + 5) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    ldr     r11, [sp, #(40 + \x * 4)]
+    eor     r10, r10, r11
+    str     r10, [r0, #(400 + \x * 8 + \h)]
+    .endm
+#elif MASKING_N == 4
+    .macro chi_lane x, b, c, h
+    @ shares of lanes x+1 (b) and x+2 (c) from the copy; share 0 of b stays
+    @ uncomplemented, BIC applies the NOT
+    ldr     r2, [sp, #(0 + \b * 4)]
+    ldr     r3, [sp, #(20 + \b * 4)]
+    ldr     r4, [sp, #(40 + \b * 4)]
+    ldr     r5, [sp, #(60 + \b * 4)]
+    ldr     r6, [sp, #(0 + \c * 4)]
+    ldr     r7, [sp, #(20 + \c * 4)]
+    ldr     r8, [sp, #(40 + \c * 4)]
+    ldr     r9, [sp, #(60 + \c * 4)]
+    @ share 0
+    bic     r10, r6, r2
+    ldr     r11, [r1, #((\x * 16 + 1) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [r1, #((\x * 16 + 2) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [r1, #((\x * 16 + 3) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [sp, #(0 + \x * 4)]
+    eor     r10, r10, r11
+    str     r10, [r0, #(0 + \x * 8 + \h)]
+    @ share 1
+    and     r10, r3, r7
+    bic     r11, r7, r2
+    and     r12, r3, r6
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 16 + 1) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    ldr     r11, [r1, #((\x * 16 + 6) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [r1, #((\x * 16 + 7) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [sp, #(20 + \x * 4)]
+    eor     r10, r10, r11
+    str     r10, [r0, #(200 + \x * 8 + \h)]
+    @ share 2
+    and     r10, r4, r8
+    bic     r11, r8, r2
+    and     r12, r4, r6
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 16 + 2) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    and     r11, r3, r8
+    and     r12, r4, r7
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 16 + 6) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    ldr     r11, [r1, #((\x * 16 + 11) * 8 + \h)]
+    eor     r10, r10, r11
+    ldr     r11, [sp, #(40 + \x * 4)]
+    eor     r10, r10, r11
+    str     r10, [r0, #(400 + \x * 8 + \h)]
+    @ share 3
+    and     r10, r5, r9
+    bic     r11, r9, r2
+    and     r12, r5, r6
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 16 + 3) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    and     r11, r3, r9
+    and     r12, r5, r7
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 16 + 7) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    and     r11, r4, r9
+    and     r12, r5, r8
+    eor     r11, r11, r12
+    ldr     r12, [r1, #((\x * 16 + 11) * 8 + \h)]
+    eor     r11, r11, r12
+    eor     r10, r10, r11
+    ldr     r11, [sp, #(60 + \x * 4)]
+    eor     r10, r10, r11
+    str     r10, [r0, #(600 + \x * 8 + \h)]
+    .endm
+#endif
+
+    .macro chi_copy h
+    .set .Lshare, 0
+    .rept MASKING_N
+    .irp x, 0, 1, 2, 3, 4
+    ldr     r2, [r0, #(.Lshare * 200 + \x * 8 + \h)]
+    str     r2, [sp, #(.Lshare * 20 + \x * 4)]
+    .endr
+    .set .Lshare, .Lshare + 1
+    .endr
+    .endm
+
+    .section .text.masked_soa_chi_row_asm,"ax",%progbits
+    .align 2
+    .global masked_soa_chi_row_asm
+    .thumb_func
+    .type masked_soa_chi_row_asm, %function
+masked_soa_chi_row_asm:
+    push    {r4-r11}
+    sub     sp, sp, #(20 * MASKING_N)
+    .irp h, 0, 4
+    chi_copy \h
+    chi_lane 0, 1, 2, \h
+    chi_lane 1, 2, 3, \h
+    chi_lane 2, 3, 4, \h
+    chi_lane 3, 4, 0, \h
+    chi_lane 4, 0, 1, \h
+    .endr
+    add     sp, sp, #(20 * MASKING_N)
+    pop     {r4-r11}
+    bx      lr
+    .size masked_soa_chi_row_asm, .-masked_soa_chi_row_asm
+
+/*
+ * Masked Keccak-p[1600, nrounds] on the share-major state.
+ *
+ * void masked_soa_keccak_p1600_asm(masked_soa_state_t *S, int nrounds,
+ *                                  uint64_t r[5][MASKING_N][MASKING_N]);
+ *
+ * The 24 rounds are unrolled, each ending in its own Iota with the round
+ * constant folded into immediates; a TBH on 24 - nrounds enters the
+ * sequence at the first round to run (0 <= nrounds <= 24). A round is one
+ * keccak_linear_layer_asm() per share, then per row chi_row_random() into
+ * the caller's buffer r and masked_soa_chi_row_asm(), exactly as
+ * masked_soa_keccak_round_ws() does in C.
+ */
+    .macro round_body
+    .set .Lshare, 0
+    .rept MASKING_N
+    add     r0, r4, #(.Lshare * 200)
+    bl      keccak_linear_layer_asm
+    .set .Lshare, .Lshare + 1
+    .endr
+    .irp y, 0, 1, 2, 3, 4
+    mov     r0, r5
+    bl      chi_row_random
+    add     r0, r4, #(\y * 40)
+    mov     r1, r5
+    bl      masked_soa_chi_row_asm
+    .endr
+    .endm
+
+    .section .text.masked_soa_keccak_p1600_asm,"ax",%progbits
+    .align 2
+    .global masked_soa_keccak_p1600_asm
+    .thumb_func
+    .type masked_soa_keccak_p1600_asm, %function
+masked_soa_keccak_p1600_asm:
+    push    {r4, r5, r6, lr}
+    mov     r4, r0
+    mov     r5, r2
+    rsb     r1, r1, #24
+    tbh     [pc, r1, lsl #1]
+.Lround_table:
+    .hword  (.Lround_0 - .Lround_table) / 2
+    .hword  (.Lround_1 - .Lround_table) / 2
+    .hword  (.Lround_2 - .Lround_table) / 2
+    .hword  (.Lround_3 - .Lround_table) / 2
+    .hword  (.Lround_4 - .Lround_table) / 2
+    .hword  (.Lround_5 - .Lround_table) / 2
+    .hword  (.Lround_6 - .Lround_table) / 2
+    .hword  (.Lround_7 - .Lround_table) / 2
+    .hword  (.Lround_8 - .Lround_table) / 2
+    .hword  (.Lround_9 - .Lround_table) / 2
+    .hword  (.Lround_10 - .Lround_table) / 2
+    .hword  (.Lround_11 - .Lround_table) / 2
+    .hword  (.Lround_12 - .Lround_table) / 2
+    .hword  (.Lround_13 - .Lround_table) / 2
+    .hword  (.Lround_14 - .Lround_table) / 2
+    .hword  (.Lround_15 - .Lround_table) / 2
+    .hword  (.Lround_16 - .Lround_table) / 2
+    .hword  (.Lround_17 - .Lround_table) / 2
+    .hword  (.Lround_18 - .Lround_table) / 2
+    .hword  (.Lround_19 - .Lround_table) / 2
+    .hword  (.Lround_20 - .Lround_table) / 2
+    .hword  (.Lround_21 - .Lround_table) / 2
+    .hword  (.Lround_22 - .Lround_table) / 2
+    .hword  (.Lround_23 - .Lround_table) / 2
+    .hword  (.Lround_end - .Lround_table) / 2
+.Lround_0:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    eor     r0, r0, #0x00000001
+    strd    r0, r1, [r4, #0]
+.Lround_1:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8082
+    eor     r0, r0, r12
+    strd    r0, r1, [r4, #0]
+.Lround_2:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x808a
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_3:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8000
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_4:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x808b
+    eor     r0, r0, r12
+    strd    r0, r1, [r4, #0]
+.Lround_5:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x0001
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    strd    r0, r1, [r4, #0]
+.Lround_6:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8081
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_7:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8009
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_8:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    eor     r0, r0, #0x0000008a
+    strd    r0, r1, [r4, #0]
+.Lround_9:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    eor     r0, r0, #0x00000088
+    strd    r0, r1, [r4, #0]
+.Lround_10:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8009
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    strd    r0, r1, [r4, #0]
+.Lround_11:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x000a
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    strd    r0, r1, [r4, #0]
+.Lround_12:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x808b
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    strd    r0, r1, [r4, #0]
+.Lround_13:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    eor     r0, r0, #0x0000008b
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_14:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8089
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_15:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8003
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_16:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8002
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_17:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    eor     r0, r0, #0x00000080
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_18:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x800a
+    eor     r0, r0, r12
+    strd    r0, r1, [r4, #0]
+.Lround_19:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x000a
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_20:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8081
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_21:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8080
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_22:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x0001
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    strd    r0, r1, [r4, #0]
+.Lround_23:
+    round_body
+    @ Iota: round constant into share 0 of lane 0
+    ldrd    r0, r1, [r4, #0]
+    movw    r12, #0x8008
+    movt    r12, #0x8000
+    eor     r0, r0, r12
+    eor     r1, r1, #0x80000000
+    strd    r0, r1, [r4, #0]
+.Lround_end:
+    pop     {r4, r5, r6, pc}
+    .size masked_soa_keccak_p1600_asm, .-masked_soa_keccak_p1600_asm
+#endif
+
+    @ Share count this file was assembled for, checked against the C side.
+    .section .rodata.masked_keccak_asm_shares,"a",%progbits
+    .align 2
+    .global masked_keccak_asm_shares
+    .type masked_keccak_asm_shares, %object
+masked_keccak_asm_shares:
+    .word   MASKING_N
+    .size masked_keccak_asm_shares, .-masked_keccak_asm_shares
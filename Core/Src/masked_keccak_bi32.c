@@ -0,0 +1,417 @@
+#include "masked_types.h"
+#include "masked_gadgets.h"
+#include "masked_keccak.h"
+#include "masked_keccak_bi32.h"
+#include "params.h"
+#include <stddef.h>
+#include <stdint.h>
+/*
+ * Keccak-f[1600] — Bit-Interleaved Masked Backend (32-bit cores)
+
+    On a 32-bit core every 64-bit rotation in Theta and Rho costs several
+    shifts/ORs across a register pair. Bit interleaving stores each share
+    of a lane as two 32-bit words: one holding the even-indexed bits and
+    one holding the odd-indexed bits.
+
+    A 64-bit rotation by n then becomes two independent 32-bit rotations:
+      n even:  even' = rol32(even, n/2),       odd' = rol32(odd, n/2)
+      n odd:   even' = rol32(odd, (n+1)/2),    odd' = rol32(even, (n-1)/2)
+    Rho is written out per lane, so the parity is fixed at compile time
+    and every rotation is a single ROR by an immediate; Theta's 1-bit
+    rotation folds into its EOR as a shifted operand.
+
+    The interleaving is a fixed bit permutation applied to every share
+    independently, so it is linear and keeps the XOR masking intact.
+    Chi uses the same ISW-style cross terms as masked_and(), split into
+    the even and odd halves of one 64-bit randomness matrix per lane.
+
+ *
+ */
+
+//Round constants from RC[] pre-converted to {even, odd} form.
+static const bi32_word_t keccak_rc_bi32[24] = {
+    { 0x00000001UL, 0x00000000UL }, { 0x00000000UL, 0x00000089UL },
+    { 0x00000000UL, 0x8000008bUL }, { 0x00000000UL, 0x80008080UL },
+    { 0x00000001UL, 0x0000008bUL }, { 0x00000001UL, 0x00008000UL },
+    { 0x00000001UL, 0x80008088UL }, { 0x00000001UL, 0x80000082UL },
+    { 0x00000000UL, 0x0000000bUL }, { 0x00000000UL, 0x0000000aUL },
+    { 0x00000001UL, 0x00008082UL }, { 0x00000000UL, 0x00008003UL },
+    { 0x00000001UL, 0x0000808bUL }, { 0x00000001UL, 0x8000000bUL },
+    { 0x00000001UL, 0x8000008aUL }, { 0x00000001UL, 0x80000081UL },
+    { 0x00000000UL, 0x80000081UL }, { 0x00000000UL, 0x80000008UL },
+    { 0x00000000UL, 0x00000083UL }, { 0x00000000UL, 0x80008003UL },
+    { 0x00000001UL, 0x80008088UL }, { 0x00000000UL, 0x80000088UL },
+    { 0x00000001UL, 0x00008000UL }, { 0x00000000UL, 0x80008082UL }
+};
+
+//Performs a circular left shift of a 32-bit word by n bits (n in 0..31).
+static inline uint32_t rol32(uint32_t x, unsigned int n) {
+    return (x << n) | (x >> ((32 - n) & 31));
+}
+
+//Rotates every share of lane (x, y) left by an even constant n: each half
+// rotates by n/2 in place.
+#define BI32_RHO_EVEN(x, y, n)                                          \
+    do {                                                                \
+        for (int i = 0; i < MASKING_N; i++) {                           \
+            bi32_word_t *w = &state[x][y].share[i];                     \
+            w->even = rol32(w->even, (n) / 2);                          \
+            w->odd  = rol32(w->odd, (n) / 2);                           \
+        }                                                               \
+    } while (0)
+
+//Rotates every share of lane (x, y) left by an odd constant n: the halves
+// swap, the new even half rotating by (n+1)/2 and the new odd one by n/2.
+#define BI32_RHO_ODD(x, y, n)                                           \
+    do {                                                                \
+        for (int i = 0; i < MASKING_N; i++) {                           \
+            bi32_word_t *w = &state[x][y].share[i];                     \
+            uint32_t even = w->even;                                    \
+            w->even = rol32(w->odd, ((n) + 1) / 2);                     \
+            w->odd  = rol32(even, (n) / 2);                             \
+        }                                                               \
+    } while (0)
+
+//Swaps the bits selected by mask with the bits shift positions above them.
+static inline uint32_t delta_swap32(uint32_t x, uint32_t mask, unsigned int shift) {
+    uint32_t t = (x ^ (x >> shift)) & mask;
+    return x ^ t ^ (t << shift);
+}
+
+//Moves the even bits of a 32-bit word to its low half and the odd bits to its high half.
+static inline uint32_t unzip32(uint32_t x) {
+    x = delta_swap32(x, 0x22222222UL, 1);
+    x = delta_swap32(x, 0x0C0C0C0CUL, 2);
+    x = delta_swap32(x, 0x00F000F0UL, 4);
+    x = delta_swap32(x, 0x0000FF00UL, 8);
+    return x;
+}
+
+//Inverse of unzip32().
+static inline uint32_t zip32(uint32_t x) {
+    x = delta_swap32(x, 0x0000FF00UL, 8);
+    x = delta_swap32(x, 0x00F000F0UL, 4);
+    x = delta_swap32(x, 0x0C0C0C0CUL, 2);
+    x = delta_swap32(x, 0x22222222UL, 1);
+    return x;
+}
+
+MASKED_RAMFUNC bi32_word_t bi32_from_uint64(uint64_t x) {
+    uint32_t lo = unzip32((uint32_t)x);
+    uint32_t hi = unzip32((uint32_t)(x >> 32));
+    bi32_word_t w;
+    w.even = (lo & 0x0000FFFFUL) | (hi << 16);
+    w.odd  = (lo >> 16) | (hi & 0xFFFF0000UL);
+    return w;
+}
+
+MASKED_RAMFUNC uint64_t bi32_to_uint64(bi32_word_t w) {
+    uint32_t lo = (w.even & 0x0000FFFFUL) | (w.odd << 16);
+    uint32_t hi = (w.even >> 16) | (w.odd & 0xFFFF0000UL);
+    return ((uint64_t)zip32(hi) << 32) | zip32(lo);
+}
+
+MASKED_RAMFUNC void masked_bi32_from_state(masked_bi32_lane_t out[5][5], const masked_uint64_t in[5][5]) {
+    for (int x = 0; x < 5; x++)
+        for (int y = 0; y < 5; y++)
+            for (int i = 0; i < MASKING_N; i++)
+                out[x][y].share[i] = bi32_from_uint64(in[x][y].share[i]);
+}
+
+MASKED_RAMFUNC void masked_bi32_to_state(masked_uint64_t out[5][5], const masked_bi32_lane_t in[5][5]) {
+    for (int x = 0; x < 5; x++)
+        for (int y = 0; y < 5; y++)
+            for (int i = 0; i < MASKING_N; i++)
+                out[x][y].share[i] = bi32_to_uint64(in[x][y].share[i]);
+}
+
+//======Five Main Round Functions (interleaved)======
+
+/**
+ * Apply the masked Theta step on the interleaved state.
+ *
+ * Identical to masked_theta() except the 1-bit rotation of C[x+1]
+ * becomes a swap of the even/odd words plus a 1-bit rotate of one of them.
+ */
+MASKED_RAMFUNC void masked_bi32_theta(masked_bi32_lane_t state[5][5]) {
+    for (int i = 0; i < MASKING_N; i++) {
+        bi32_word_t C[5], D;
+
+        for (int x = 0; x < 5; x++) {
+            C[x] = state[x][0].share[i];
+            for (int y = 1; y < 5; y++) {
+                C[x].even ^= state[x][y].share[i].even;
+                C[x].odd  ^= state[x][y].share[i].odd;
+            }
+        }
+
+        for (int x = 0; x < 5; x++) {
+            const bi32_word_t *cm = &C[(x + 4) % 5];
+            const bi32_word_t *cp = &C[(x + 1) % 5];
+            D.even = cm->even ^ rol32(cp->odd, 1);
+            D.odd  = cm->odd  ^ cp->even;
+            for (int y = 0; y < 5; y++) {
+                state[x][y].share[i].even ^= D.even;
+                state[x][y].share[i].odd  ^= D.odd;
+            }
+        }
+    }
+}
+
+/**
+ * Apply the masked Rho step on the interleaved state.
+ *
+ * Every 64-bit rotation is replaced by two 32-bit rotations with constant
+ * counts; the offsets are those of keccak_rho_offsets in masked_keccak.c.
+ * Lane (0,0) has offset 0 and is left alone.
+ */
+MASKED_RAMFUNC void masked_bi32_rho(masked_bi32_lane_t state[5][5]) {
+    BI32_RHO_EVEN(0, 1, 36);
+    BI32_RHO_ODD (0, 2,  3);
+    BI32_RHO_ODD (0, 3, 41);
+    BI32_RHO_EVEN(0, 4, 18);
+
+    BI32_RHO_ODD (1, 0,  1);
+    BI32_RHO_EVEN(1, 1, 44);
+    BI32_RHO_EVEN(1, 2, 10);
+    BI32_RHO_ODD (1, 3, 45);
+    BI32_RHO_EVEN(1, 4,  2);
+
+    BI32_RHO_EVEN(2, 0, 62);
+    BI32_RHO_EVEN(2, 1,  6);
+    BI32_RHO_ODD (2, 2, 43);
+    BI32_RHO_ODD (2, 3, 15);
+    BI32_RHO_ODD (2, 4, 61);
+
+    BI32_RHO_EVEN(3, 0, 28);
+    BI32_RHO_ODD (3, 1, 55);
+    BI32_RHO_ODD (3, 2, 25);
+    BI32_RHO_ODD (3, 3, 21);
+    BI32_RHO_EVEN(3, 4, 56);
+
+    BI32_RHO_ODD (4, 0, 27);
+    BI32_RHO_EVEN(4, 1, 20);
+    BI32_RHO_ODD (4, 2, 39);
+    BI32_RHO_EVEN(4, 3,  8);
+    BI32_RHO_EVEN(4, 4, 14);
+}
+
+/**
+ * Apply the masked Pi step on the interleaved state.
+ *
+ * Pure lane relocation; the representation of each lane is irrelevant.
+ */
+MASKED_RAMFUNC void masked_bi32_pi(masked_bi32_lane_t state[5][5]) {
+    // Walk the Pi cycle from lane (1,0) carrying one lane, so no state copy
+    // is needed; lane (0,0) is a fixed point.
+    masked_bi32_lane_t carry = state[1][0];
+    int x = 1, y = 0;
+
+    for (int k = 0; k < 24; k++) {
+        int nx = y, ny = (2 * x + 3 * y) % 5;
+        masked_bi32_lane_t next = state[nx][ny];
+
+        state[nx][ny] = carry;
+        carry = next;
+        x = nx;
+        y = ny;
+    }
+}
+
+//Masked AND on one interleaved half, using one 32-bit slice of the randomness matrix.
+static inline void masked_and32(uint32_t out[MASKING_N],
+                                const uint32_t a[MASKING_N],
+                                const uint32_t b[MASKING_N],
+                                const uint32_t r[MASKING_N][MASKING_N]) {
+    for (size_t i = 0; i < MASKING_N; i++) {
+        out[i] = a[i] & b[i];
+    }
+
+    for (size_t i = 0; i < MASKING_N; i++) {
+        for (size_t j = i + 1; j < MASKING_N; j++) {
+            uint32_t cross_term = (a[i] & b[j]) ^ (a[j] & b[i]);
+            out[i] ^= r[i][j];
+            out[j] ^= cross_term ^ r[i][j];
+        }
+    }
+}
+
+#if MASKED_TI
+//3-share threshold Chi on one 32-bit half of a row (see ti_chi_row()).
+// The even half uses the low and the odd half the high words of the
+// guards, and hands on its own shares 1 and 2 in the same place.
+static MASKED_RAMFUNC void ti_chi_row32(masked_bi32_lane_t state[5][5], int y,
+                                        const uint32_t row[5][MASKING_N], int odd) {
+    const int shift = odd ? 32 : 0;
+
+    for (int x = 0; x < 5; x++) {
+        const uint32_t *a = row[x];
+        const uint32_t *b = row[(x + 1) % 5];
+        const uint32_t *c = row[(x + 2) % 5];
+        const uint32_t g1 = (uint32_t)(ti_chi_guard[0][x] >> shift);
+        const uint32_t g2 = (uint32_t)(ti_chi_guard[1][x] >> shift);
+        uint32_t out[3];
+
+        out[0] = a[1] ^ (~b[1] & c[1]) ^ (b[1] & c[2]) ^ (b[2] & c[1]) ^ g1 ^ g2;
+        out[1] = a[2] ^ (~b[2] & c[2]) ^ (b[2] & c[0]) ^ (b[0] & c[2]) ^ g2;
+        out[2] = a[0] ^ (~b[0] & c[0]) ^ (b[0] & c[1]) ^ (b[1] & c[0]) ^ g1;
+
+        for (int i = 0; i < 3; i++) {
+            if (odd)
+                state[x][y].share[i].odd = out[i];
+            else
+                state[x][y].share[i].even = out[i];
+        }
+    }
+
+    for (int x = 0; x < 5; x++) {
+        for (int i = 0; i < 2; i++) {
+            ti_chi_guard[i][x] &= ~((uint64_t)0xFFFFFFFFu << shift);
+            ti_chi_guard[i][x] |= (uint64_t)row[x][i + 1] << shift;
+        }
+    }
+}
+#endif
+
+/**
+ * Apply the masked Chi step on the interleaved state, in place.
+ *
+ * Chi is bitwise, so the even and odd halves are processed independently.
+ * Each lane takes its 64-bit matrix from chi_row_random(); its low word
+ * masks the even half and its high word masks the odd half, so the
+ * randomness budget matches the 64-bit reference exactly.
+ */
+MASKED_RAMFUNC void masked_bi32_chi(masked_bi32_lane_t state[5][5]) {
+#if MASKED_TI
+    masked_bi32_chi_ws(state, NULL);
+#else
+    uint64_t r[5][MASKING_N][MASKING_N];
+    masked_bi32_chi_ws(state, r);
+#endif
+}
+
+//Same, with the row randomness drawn into the caller's buffer r (unused in TI mode).
+MASKED_RAMFUNC void masked_bi32_chi_ws(masked_bi32_lane_t state[5][5], uint64_t r[5][MASKING_N][MASKING_N]) {
+    for (int y = 0; y < 5; y++) {
+        // Copy out the row so results can be written back in place.
+        uint32_t row_e[5][MASKING_N], row_o[5][MASKING_N];
+        for (int x = 0; x < 5; x++) {
+            for (int i = 0; i < MASKING_N; i++) {
+                row_e[x][i] = state[x][y].share[i].even;
+                row_o[x][i] = state[x][y].share[i].odd;
+            }
+        }
+
+#if MASKED_TI
+        (void)r;
+        ti_chi_row32(state, y, row_e, 0);
+        ti_chi_row32(state, y, row_o, 1);
+#else
+        chi_row_random(r);
+
+        for (int x = 0; x < 5; x++) {
+            uint32_t r_e[MASKING_N][MASKING_N], r_o[MASKING_N][MASKING_N];
+            for (int i = 0; i < MASKING_N; i++) {
+                for (int j = 0; j < MASKING_N; j++) {
+                    r_e[i][j] = (uint32_t)r[x][i][j];
+                    r_o[i][j] = (uint32_t)(r[x][i][j] >> 32);
+                }
+            }
+
+            // NOT only needs to flip one share to flip the recombined value.
+            uint32_t nb_e[MASKING_N], nb_o[MASKING_N];
+            for (int i = 0; i < MASKING_N; i++) {
+                nb_e[i] = row_e[(x + 1) % 5][i];
+                nb_o[i] = row_o[(x + 1) % 5][i];
+            }
+            nb_e[0] = ~nb_e[0];
+            nb_o[0] = ~nb_o[0];
+
+            uint32_t t_e[MASKING_N], t_o[MASKING_N];
+            masked_and32(t_e, nb_e, row_e[(x + 2) % 5], r_e);
+            masked_and32(t_o, nb_o, row_o[(x + 2) % 5], r_o);
+
+            for (int i = 0; i < MASKING_N; i++) {
+                state[x][y].share[i].even = row_e[x][i] ^ t_e[i];
+                state[x][y].share[i].odd  = row_o[x][i] ^ t_o[i];
+            }
+        }
+#endif
+    }
+}
+
+/**
+ * Apply the masked Iota step on the interleaved state.
+ *
+ * Mirrors masked_iota(): the interleaved round constant goes into share 0,
+ * or with MASKED_IOTA_REMASK the lane is recombined and re-masked.
+ */
+MASKED_RAMFUNC void masked_bi32_iota(masked_bi32_lane_t state[5][5], int round) {
+#if MASKED_IOTA_REMASK
+    bi32_word_t value = { 0, 0 };
+    for (int i = 0; i < MASKING_N; ++i) {
+        value.even ^= state[0][0].share[i].even;
+        value.odd  ^= state[0][0].share[i].odd;
+    }
+
+    value.even ^= keccak_rc_bi32[round].even;
+    value.odd  ^= keccak_rc_bi32[round].odd;
+
+    for (int i = 1; i < MASKING_N; ++i) {
+        uint64_t r = get_random64();
+        state[0][0].share[i].even = (uint32_t)r;
+        state[0][0].share[i].odd  = (uint32_t)(r >> 32);
+        value.even ^= state[0][0].share[i].even;
+        value.odd  ^= state[0][0].share[i].odd;
+    }
+    state[0][0].share[0] = value;
+#else
+    state[0][0].share[0].even ^= keccak_rc_bi32[round].even;
+    state[0][0].share[0].odd  ^= keccak_rc_bi32[round].odd;
+#endif
+}
+
+MASKED_RAMFUNC void masked_bi32_keccak_round(masked_bi32_lane_t state[5][5], int round) {
+    masked_bi32_theta(state);
+    masked_bi32_rho(state);
+    masked_bi32_pi(state);
+    masked_bi32_chi(state);
+    masked_bi32_iota(state, round);
+}
+
+/**
+ * Perform the full Keccak-f[1600] permutation using the bit-interleaved backend.
+ *
+ * The conversion in and out is done once per permutation, not per round,
+ * so its cost is amortised over all 24 rounds.
+ *
+ * state is the 5×5 masked Keccak state in the normal 64-bit representation.
+ */
+MASKED_RAMFUNC void masked_keccak_f1600_bi32(masked_uint64_t state[5][5]) {
+    masked_keccak_p1600_bi32(state, NROUNDS);
+}
+
+//Keccak-p[1600, nrounds]: the last nrounds rounds, converted in and out once.
+MASKED_RAMFUNC void masked_keccak_p1600_bi32(masked_uint64_t state[5][5], int nrounds) {
+    masked_bi32_lane_t S[5][5];
+
+    masked_bi32_from_state(S, state);
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_bi32_keccak_round(S, i);
+    }
+    masked_bi32_to_state(state, S);
+}
+
+//Same, with the interleaved state S and the Chi row randomness r supplied by the caller.
+MASKED_RAMFUNC void masked_keccak_p1600_bi32_ws(masked_uint64_t state[5][5], int nrounds,
+                                                masked_bi32_lane_t S[5][5], uint64_t r[5][MASKING_N][MASKING_N]) {
+    masked_bi32_from_state(S, state);
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_bi32_theta(S);
+        masked_bi32_rho(S);
+        masked_bi32_pi(S);
+        masked_bi32_chi_ws(S, r);
+        masked_bi32_iota(S, i);
+    }
+    masked_bi32_to_state(state, S);
+}
@@ -0,0 +1,41 @@
+#ifndef MASKED_KECCAK_BI32_H
+#define MASKED_KECCAK_BI32_H
+
+#include <stdint.h>
+#include "masked_types.h"
+
+// One share of a lane in bit-interleaved form:
+// even holds bits 0,2,4,...,62 and odd holds bits 1,3,5,...,63 of the 64-bit lane.
+typedef struct {
+    uint32_t even;
+    uint32_t odd;
+} bi32_word_t;
+
+typedef struct {
+    bi32_word_t share[MASKING_N];
+} masked_bi32_lane_t;
+
+// === Representation Conversion (share-wise, so masking is preserved) ===
+bi32_word_t bi32_from_uint64(uint64_t x);
+uint64_t bi32_to_uint64(bi32_word_t w);
+void masked_bi32_from_state(masked_bi32_lane_t out[5][5], const masked_uint64_t in[5][5]);
+void masked_bi32_to_state(masked_uint64_t out[5][5], const masked_bi32_lane_t in[5][5]);
+
+// === Round Functions (bit-interleaved domain) ===
+void masked_bi32_theta(masked_bi32_lane_t state[5][5]);
+void masked_bi32_rho(masked_bi32_lane_t state[5][5]);
+void masked_bi32_pi(masked_bi32_lane_t state[5][5]);
+void masked_bi32_chi(masked_bi32_lane_t state[5][5]);
+void masked_bi32_chi_ws(masked_bi32_lane_t state[5][5], uint64_t r[5][MASKING_N][MASKING_N]);
+void masked_bi32_iota(masked_bi32_lane_t state[5][5], int round);
+void masked_bi32_keccak_round(masked_bi32_lane_t state[5][5], int round);
+
+// === Permutation Wrapper ===
+// Converts the 64-bit masked state in, runs all 24 rounds interleaved, converts back.
+void masked_keccak_f1600_bi32(masked_uint64_t state[5][5]);
+void masked_keccak_p1600_bi32(masked_uint64_t state[5][5], int nrounds);
+// Same, with the interleaved state and the Chi row randomness in caller buffers.
+void masked_keccak_p1600_bi32_ws(masked_uint64_t state[5][5], int nrounds,
+                                 masked_bi32_lane_t S[5][5], uint64_t r[5][MASKING_N][MASKING_N]);
+
+#endif // MASKED_KECCAK_BI32_H
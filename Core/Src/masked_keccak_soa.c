@@ -0,0 +1,325 @@
+#include "masked_types.h"
+#include "masked_gadgets.h"
+#include "masked_keccak.h"
+#include "masked_keccak_soa.h"
+#include "params.h"
+#include <stddef.h>
+#include <stdint.h>
+/*
+ * Keccak-F[1600] — Share-Major (SoA) Masked Backend
+
+    The reference backend stores the shares of a lane next to each other
+    (state[x][y].share[i]), so every linear step walks 25 lanes and, inside
+    that, MASKING_N shares.
+
+    Here the state is transposed to share[MASKING_N][25]. Theta, Rho and Pi
+    are linear, so the masked linear layer is exactly the plain Keccak linear
+    layer run once on each share's 25 contiguous lanes. Only Chi (and the
+    recombine in Iota) has to look at several shares of the same lane.
+
+ *
+ */
+
+//Rho rotation offsets and Pi lane order for an in-place Rho+Pi walk
+//over the 24-lane Pi cycle that starts at lane 1 (index x + 5*y).
+static const uint8_t keccak_rotc[24] = {
+     1,  3,  6, 10, 15, 21, 28, 36, 45, 55,  2, 14,
+    27, 41, 56,  8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+static const uint8_t keccak_piln[24] = {
+    10,  7, 11, 17, 18,  3,  5, 16,  8, 21, 24,  4,
+    15, 23, 19, 13, 12,  2, 20, 14, 22,  9,  6,  1
+};
+
+//Performs a circular left shift (rotate-left) of a 64-bit word by n bits (n in 1..63).
+static inline uint64_t rol64(uint64_t x, unsigned int n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+MASKED_RAMFUNC void masked_soa_from_state(masked_soa_state_t *out, const masked_uint64_t in[5][5]) {
+    for (int i = 0; i < MASKING_N; i++)
+        for (int y = 0; y < 5; y++)
+            for (int x = 0; x < 5; x++)
+                out->share[i][x + 5 * y] = in[x][y].share[i];
+}
+
+MASKED_RAMFUNC void masked_soa_to_state(masked_uint64_t out[5][5], const masked_soa_state_t *in) {
+    for (int i = 0; i < MASKING_N; i++)
+        for (int y = 0; y < 5; y++)
+            for (int x = 0; x < 5; x++)
+                out[x][y].share[i] = in->share[i][x + 5 * y];
+}
+
+/**
+ * Apply Theta, Rho and Pi to a single (unmasked) 25-lane state.
+ *
+ * Because all three steps are linear, calling this on every share of a
+ * masked state is the masked linear layer. Rho and Pi are done together
+ * in place by following the Pi cycle, so no temporary state is needed.
+ *
+ * @param A 25 lanes of one share, indexed x + 5*y
+ */
+MASKED_RAMFUNC void keccak_linear_layer(uint64_t A[25]) {
+    uint64_t C[5], D, t, next;
+
+    // Theta
+    for (int x = 0; x < 5; x++)
+        C[x] = A[x] ^ A[x + 5] ^ A[x + 10] ^ A[x + 15] ^ A[x + 20];
+
+    for (int x = 0; x < 5; x++) {
+        D = C[(x + 4) % 5] ^ rol64(C[(x + 1) % 5], 1);
+        for (int y = 0; y < 25; y += 5)
+            A[x + y] ^= D;
+    }
+
+    // Rho + Pi (lane 0 is neither rotated nor moved)
+    t = A[1];
+    for (int i = 0; i < 24; i++) {
+        int j = keccak_piln[i];
+        next = A[j];
+        A[j] = rol64(t, keccak_rotc[i]);
+        t = next;
+    }
+}
+
+#if MASKED_KECCAK_ASM
+/**
+ * Cross-check the assembly linear layer against the C reference.
+ *
+ * Fills a 25-lane state from a fixed xorshift sequence, runs both versions
+ * on copies for several rounds (so every output feeds the next input) and
+ * counts the lanes that differ. Intended for start-up or bench builds.
+ */
+int keccak_linear_layer_asm_check(void) {
+    uint64_t ref[25], out[25], seed = 0x9E3779B97F4A7C15ULL;
+    int mismatches = 0;
+
+    for (int i = 0; i < 25; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        ref[i] = out[i] = seed;
+    }
+
+    for (int round = 0; round < 24; round++) {
+        keccak_linear_layer(ref);
+        keccak_linear_layer_asm(out);
+        for (int i = 0; i < 25; i++) {
+            if (ref[i] != out[i])
+                mismatches++;
+            out[i] = ref[i];
+        }
+    }
+    return mismatches;
+}
+#endif
+
+static MASKED_RAMFUNC void masked_soa_chi_c(masked_soa_state_t *S, uint64_t r[5][MASKING_N][MASKING_N]);
+
+#if MASKED_KECCAK_ASM
+/**
+ * Check the assembly kernel against the C round before it is used.
+ *
+ * Adds up the linear layer mismatches, a share count that differs from
+ * MASKING_N (assembler built with other options) and, when the whole
+ * permutation is in assembly, the lanes where the recombined output of
+ * masked_soa_keccak_p1600_asm() differs from the C round for 24 and for
+ * 12 rounds. Both sides draw their own Chi randomness, so only the
+ * recombined lanes can be compared. main() stops on any mismatch.
+ */
+int masked_soa_keccak_asm_check(void) {
+    int mismatches = keccak_linear_layer_asm_check();
+
+    if (masked_keccak_asm_shares != MASKING_N)
+        return mismatches + 1;
+
+#if MASKED_KECCAK_ASM_ROUND
+    static masked_soa_state_t ref, out;
+    uint64_t r[5][MASKING_N][MASKING_N], seed = 0xD1B54A32D192ED03ULL;
+
+    for (int l = 0; l < 25; l++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        ref.share[0][l] = seed;
+        for (int i = 1; i < MASKING_N; i++) {
+            ref.share[i][l] = get_random64();
+            ref.share[0][l] ^= ref.share[i][l];
+        }
+    }
+
+    for (int nrounds = 24; nrounds >= 12; nrounds -= 12) {
+        out = ref;
+        for (int round = 24 - nrounds; round < 24; round++) {
+            for (int i = 0; i < MASKING_N; i++)
+                keccak_linear_layer(ref.share[i]);
+            masked_soa_chi_c(&ref, r);
+            masked_soa_iota(&ref, RC[round]);
+        }
+        masked_soa_keccak_p1600_asm(&out, nrounds, r);
+
+        for (int l = 0; l < 25; l++) {
+            uint64_t diff = 0;
+            for (int i = 0; i < MASKING_N; i++)
+                diff ^= ref.share[i][l] ^ out.share[i][l];
+            if (diff != 0)
+                mismatches++;
+        }
+    }
+#endif
+    return mismatches;
+}
+#endif
+
+/**
+ * Apply the masked Chi step to the share-major state, in place.
+ *
+ * Each row is gathered into masked lanes so the existing masked_not /
+ * masked_and / masked_xor gadgets can be reused unchanged, with the
+ * row randomness drawn as in the reference round.
+ */
+MASKED_RAMFUNC void masked_soa_chi(masked_soa_state_t *S) {
+#if MASKED_TI
+    masked_soa_chi_ws(S, NULL);
+#else
+    uint64_t r[5][MASKING_N][MASKING_N];
+    masked_soa_chi_ws(S, r);
+#endif
+}
+
+//Same, with the row randomness drawn into the caller's buffer r (unused in TI mode).
+MASKED_RAMFUNC void masked_soa_chi_ws(masked_soa_state_t *S, uint64_t r[5][MASKING_N][MASKING_N]) {
+#if MASKED_KECCAK_ASM_ROUND
+    for (int y = 0; y < 25; y += 5) {
+        chi_row_random(r);
+        masked_soa_chi_row_asm(&S->share[0][y], r);
+    }
+#else
+    masked_soa_chi_c(S, r);
+#endif
+}
+
+//Chi in C, row by row; the reference for masked_soa_chi_row_asm().
+static MASKED_RAMFUNC void masked_soa_chi_c(masked_soa_state_t *S, uint64_t r[5][MASKING_N][MASKING_N]) {
+    for (int y = 0; y < 25; y += 5) {
+        masked_uint64_t row[5];
+        for (int x = 0; x < 5; x++)
+            for (int i = 0; i < MASKING_N; i++)
+                row[x].share[i] = S->share[i][x + y];
+
+#if MASKED_TI
+        masked_uint64_t out[5];
+        (void)r;
+        ti_chi_row(out, row);
+        for (int x = 0; x < 5; x++)
+            for (int i = 0; i < MASKING_N; i++)
+                S->share[i][x + y] = out[x].share[i];
+#else
+        chi_row_random(r);
+        for (int x = 0; x < 5; x++) {
+            masked_uint64_t t1, t2, out;
+
+            masked_not(&t1, &row[(x + 1) % 5]);
+            masked_and(&t2, &t1, &row[(x + 2) % 5], r[x]);
+            masked_xor(&out, &row[x], &t2);
+
+            for (int i = 0; i < MASKING_N; i++)
+                S->share[i][x + y] = out.share[i];
+        }
+#endif
+    }
+}
+
+/**
+ * Apply the masked Iota step to the share-major state.
+ *
+ * Same as masked_iota(): the constant goes into share 0 unless
+ * MASKED_IOTA_REMASK selects the legacy recombine-and-remask.
+ */
+MASKED_RAMFUNC void masked_soa_iota(masked_soa_state_t *S, uint64_t rc) {
+#if MASKED_IOTA_REMASK
+    uint64_t value = 0;
+    for (int i = 0; i < MASKING_N; ++i)
+        value ^= S->share[i][0];
+
+    value ^= rc;
+
+    for (int i = 1; i < MASKING_N; ++i) {
+        S->share[i][0] = get_random64();
+        value ^= S->share[i][0];
+    }
+    S->share[0][0] = value;
+#else
+    S->share[0][0] ^= rc;
+#endif
+}
+
+MASKED_RAMFUNC void masked_soa_keccak_round(masked_soa_state_t *S, uint64_t rc) {
+#if MASKED_TI
+    masked_soa_keccak_round_ws(S, rc, NULL);
+#else
+    uint64_t r[5][MASKING_N][MASKING_N];
+    masked_soa_keccak_round_ws(S, rc, r);
+#endif
+}
+
+//Same, with the Chi row randomness drawn into the caller's buffer r.
+MASKED_RAMFUNC void masked_soa_keccak_round_ws(masked_soa_state_t *S, uint64_t rc, uint64_t r[5][MASKING_N][MASKING_N]) {
+    // Linear part: one plain Keccak linear layer per share.
+    for (int i = 0; i < MASKING_N; i++) {
+#if MASKED_KECCAK_ASM
+        keccak_linear_layer_asm(S->share[i]);
+#else
+        keccak_linear_layer(S->share[i]);
+#endif
+    }
+
+    masked_soa_chi_ws(S, r);
+    masked_soa_iota(S, rc);
+}
+
+/**
+ * Perform the full Keccak-f[1600] permutation on a share-major masked state.
+ */
+MASKED_RAMFUNC void masked_soa_keccak_f1600(masked_soa_state_t *S) {
+    masked_soa_keccak_p1600(S, NROUNDS);
+}
+
+//Keccak-p[1600, nrounds]: the last nrounds rounds of Keccak-f[1600].
+MASKED_RAMFUNC void masked_soa_keccak_p1600(masked_soa_state_t *S, int nrounds) {
+#if MASKED_KECCAK_ASM_ROUND
+    uint64_t r[5][MASKING_N][MASKING_N];
+    masked_soa_keccak_p1600_asm(S, nrounds, r);
+#else
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_soa_keccak_round(S, RC[i]);
+    }
+#endif
+}
+
+MASKED_RAMFUNC void masked_keccak_f1600_soa(masked_uint64_t state[5][5]) {
+    masked_keccak_p1600_soa(state, NROUNDS);
+}
+
+MASKED_RAMFUNC void masked_keccak_p1600_soa(masked_uint64_t state[5][5], int nrounds) {
+    masked_soa_state_t S;
+
+    masked_soa_from_state(&S, state);
+    masked_soa_keccak_p1600(&S, nrounds);
+    masked_soa_to_state(state, &S);
+}
+
+//Same, with the share-major state S and the Chi row randomness r supplied by the caller.
+MASKED_RAMFUNC void masked_keccak_p1600_soa_ws(masked_uint64_t state[5][5], int nrounds,
+                                               masked_soa_state_t *S, uint64_t r[5][MASKING_N][MASKING_N]) {
+    masked_soa_from_state(S, state);
+#if MASKED_KECCAK_ASM_ROUND
+    masked_soa_keccak_p1600_asm(S, nrounds, r);
+#else
+    for (int i = 24 - nrounds; i < 24; i++) {
+        masked_soa_keccak_round_ws(S, RC[i], r);
+    }
+#endif
+    masked_soa_to_state(state, S);
+}
@@ -0,0 +1,54 @@
+#ifndef MASKED_KECCAK_SOA_H
+#define MASKED_KECCAK_SOA_H
+
+#include <stdint.h>
+#include "masked_types.h"
+
+// Share-major masked state: share[i] is a complete, contiguous Keccak state
+// (lane index x + 5*y) holding the i-th share of every lane.
+typedef struct {
+    uint64_t share[MASKING_N][25];
+} masked_soa_state_t;
+
+// === Layout Conversion ===
+void masked_soa_from_state(masked_soa_state_t *out, const masked_uint64_t in[5][5]);
+void masked_soa_to_state(masked_uint64_t out[5][5], const masked_soa_state_t *in);
+
+// === Round Functions (share-major domain) ===
+// Theta, Rho and Pi on one unmasked 25-lane state; called once per share.
+void keccak_linear_layer(uint64_t A[25]);
+#if MASKED_KECCAK_ASM
+// Same as keccak_linear_layer(), Thumb-2 assembly (masked_keccak_asm.s).
+void keccak_linear_layer_asm(uint64_t A[25]);
+// Runs both versions on the same pseudo-random states; returns the number of mismatches.
+int keccak_linear_layer_asm_check(void);
+// Share count masked_keccak_asm.s was assembled for.
+extern const uint32_t masked_keccak_asm_shares;
+// Full assembly check (linear layer, share count, masked permutation);
+// returns the number of mismatches, 0 when the kernel may be used.
+int masked_soa_keccak_asm_check(void);
+#endif
+#if MASKED_KECCAK_ASM_ROUND
+// Masked Chi on the row at lane (0, y) of share 0, randomness r from chi_row_random().
+void masked_soa_chi_row_asm(uint64_t *row, const uint64_t r[5][MASKING_N][MASKING_N]);
+// Keccak-p[1600, nrounds] with the 24 rounds unrolled, Chi row randomness drawn into r.
+void masked_soa_keccak_p1600_asm(masked_soa_state_t *S, int nrounds, uint64_t r[5][MASKING_N][MASKING_N]);
+#endif
+void masked_soa_chi(masked_soa_state_t *S);
+void masked_soa_chi_ws(masked_soa_state_t *S, uint64_t r[5][MASKING_N][MASKING_N]);
+void masked_soa_iota(masked_soa_state_t *S, uint64_t rc);
+void masked_soa_keccak_round(masked_soa_state_t *S, uint64_t rc);
+// Same, with the Chi row randomness drawn into the caller's buffer r.
+void masked_soa_keccak_round_ws(masked_soa_state_t *S, uint64_t rc, uint64_t r[5][MASKING_N][MASKING_N]);
+
+// === Permutation Wrappers ===
+void masked_soa_keccak_f1600(masked_soa_state_t *S);
+void masked_soa_keccak_p1600(masked_soa_state_t *S, int nrounds);
+// Converts the [5][5] masked state to share-major form and back around the permutation.
+void masked_keccak_f1600_soa(masked_uint64_t state[5][5]);
+void masked_keccak_p1600_soa(masked_uint64_t state[5][5], int nrounds);
+// Same, with the share-major state and the Chi row randomness in caller buffers.
+void masked_keccak_p1600_soa_ws(masked_uint64_t state[5][5], int nrounds,
+                                masked_soa_state_t *S, uint64_t r[5][MASKING_N][MASKING_N]);
+
+#endif // MASKED_KECCAK_SOA_H
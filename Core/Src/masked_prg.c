@@ -0,0 +1,97 @@
+#include "masked_prg.h"
+#include "global_rng.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ChaCha state: constants, 8 key words, 2 counter words, 2 nonce words.
+static uint32_t prg_state[16] MASKED_CCM_BSS;
+static uint32_t prg_block[16] MASKED_CCM_BSS;
+static uint32_t prg_pos = 16;          // Next unread word in prg_block
+static uint32_t prg_blocks_left = 0;   // Blocks until the next reseed
+
+static inline uint32_t rotl32(uint32_t x, unsigned int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+#define CHACHA_QR(a, b, c, d)                   \
+    do {                                        \
+        a += b; d ^= a; d = rotl32(d, 16);      \
+        c += d; b ^= c; b = rotl32(b, 12);      \
+        a += b; d ^= a; d = rotl32(d, 8);       \
+        c += d; b ^= c; b = rotl32(b, 7);       \
+    } while (0)
+
+//Produce the next 16-word keystream block into prg_block and bump the counter.
+static MASKED_RAMFUNC void prg_generate_block(void) {
+    uint32_t x[16];
+
+    for (int i = 0; i < 16; i++)
+        x[i] = prg_state[i];
+
+    for (int i = 0; i < MASKED_PRG_ROUNDS; i += 2) {
+        CHACHA_QR(x[0], x[4], x[8],  x[12]);
+        CHACHA_QR(x[1], x[5], x[9],  x[13]);
+        CHACHA_QR(x[2], x[6], x[10], x[14]);
+        CHACHA_QR(x[3], x[7], x[11], x[15]);
+        CHACHA_QR(x[0], x[5], x[10], x[15]);
+        CHACHA_QR(x[1], x[6], x[11], x[12]);
+        CHACHA_QR(x[2], x[7], x[8],  x[13]);
+        CHACHA_QR(x[3], x[4], x[9],  x[14]);
+    }
+
+    for (int i = 0; i < 16; i++)
+        prg_block[i] = x[i] + prg_state[i];
+
+    // 64-bit block counter in words 12/13
+    if (++prg_state[12] == 0)
+        prg_state[13]++;
+
+    prg_pos = 0;
+}
+
+void prg_reseed(void) {
+    // "expand 32-byte k"
+    prg_state[0] = 0x61707865UL;
+    prg_state[1] = 0x3320646eUL;
+    prg_state[2] = 0x79622d32UL;
+    prg_state[3] = 0x6b206574UL;
+
+    for (int i = 4; i < 12; i += 2) {
+        uint64_t k = get_trng64();
+        prg_state[i]     = (uint32_t)k;
+        prg_state[i + 1] = (uint32_t)(k >> 32);
+    }
+
+    uint64_t nonce = get_trng64();
+    prg_state[12] = 0;
+    prg_state[13] = 0;
+    prg_state[14] = (uint32_t)nonce;
+    prg_state[15] = (uint32_t)(nonce >> 32);
+
+    prg_blocks_left = MASKED_PRG_RESEED_BLOCKS;
+    prg_pos = 16;
+}
+
+/**
+ * Take one 32-bit word of PRG output.
+ *
+ * Consumed keystream words are wiped from the block buffer, and the
+ * generator reseeds itself from the TRNG every MASKED_PRG_RESEED_BLOCKS blocks.
+ */
+MASKED_RAMFUNC uint32_t prg_random32(void) {
+    if (prg_pos == 16) {
+        if (prg_blocks_left == 0)
+            prg_reseed();
+        prg_generate_block();
+        prg_blocks_left--;
+    }
+
+    uint32_t word = prg_block[prg_pos];
+    prg_block[prg_pos++] = 0;
+    return word;
+}
+
+MASKED_RAMFUNC uint64_t prg_random64(void) {
+    uint64_t hi = prg_random32();
+    return (hi << 32) | prg_random32();
+}
@@ -0,0 +1,20 @@
+#ifndef MASKED_PRG_H
+#define MASKED_PRG_H
+
+#include <stdint.h>
+#include "params.h"
+
+// ChaCha-based expander for masking randomness.
+//
+// A 256-bit key and 64-bit nonce are drawn from the TRNG (get_trng64), then
+// ChaCha blocks are generated on demand at memory speed. After
+// MASKED_PRG_RESEED_BLOCKS blocks (64 bytes each) the key is replaced with
+// fresh TRNG output, which bounds how much mask material depends on one seed.
+
+// Draw a new key/nonce from the TRNG and restart the block counter.
+void prg_reseed(void);
+
+uint32_t prg_random32(void);
+uint64_t prg_random64(void);
+
+#endif // MASKED_PRG_H
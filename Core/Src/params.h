@@ -1,14 +1,34 @@
 #ifndef PARAMS_H
 #define PARAMS_H
 
+// Threshold implementation mode: 1 = first-order 3-share TI, where Chi
+// is kept uniform by changing of the guards and draws only 10 fresh words
+// per permutation (MASKING_ORDER must be 1),
+//                                  0 = ISW-style gadgets with MASKING_ORDER + 1 shares
+#ifndef MASKED_TI
+#define MASKED_TI 0
+#endif
+
 #ifndef MASKING_ORDER
+#if MASKED_TI
+#define MASKING_ORDER 1
+#else
 #define MASKING_ORDER 3
 #endif
+#endif
 
 #define MAX_ORDER 10      // Optional upper bound for static arrays, sanity checks, etc.
 
 #define NROUNDS 24
+
+#if MASKED_TI
+#if MASKING_ORDER != 1
+#error "MASKED_TI is a first-order scheme, build it with MASKING_ORDER=1"
+#endif
+#define MASKING_N 3
+#else
 #define MASKING_N (MASKING_ORDER + 1)
+#endif
 
 //  Keccak/SHAKE rate constants
 #define KECCAK_RATE 168
@@ -21,4 +41,152 @@
 #define DOMAIN_SHA3   0x06
 #define DOMAIN_SHAKE  0x1F
 
+// TurboSHAKE / KangarooTwelve (RFC 9861): Keccak-p[1600, 12]
+#define TURBOSHAKE_ROUNDS   12
+#define DOMAIN_TURBOSHAKE   0x1F  // Default D; any byte in 0x01..0x7F is allowed
+#define K12_CHUNK_SIZE      8192  // Leaf size of the KangarooTwelve tree
+
+// Masked Keccak-f[1600] permutation backends
+#define KECCAK_BACKEND_LANE64  0  // Reference: one uint64_t per share
+#define KECCAK_BACKEND_BI32    1  // Bit-interleaved even/odd uint32_t pair per share (Cortex-M4)
+#define KECCAK_BACKEND_SOA     2  // Share-major share[MASKING_N][25], plain linear layer per share
+#define KECCAK_BACKEND_FUSED   3  // Reference layout, fused in-place theta/rho/pi and in-place chi
+#define KECCAK_BACKEND_LANECOMP 4 // Fused layout with six lanes kept complemented: 5 NOTs per round instead of 25
+#define KECCAK_BACKEND_HOST_SIMD 5 // Host only (Host/masked_keccak_simd.c): one AVX2/AVX-512 register per lane
+
+#ifndef MASKED_KECCAK_BACKEND
+#define MASKED_KECCAK_BACKEND KECCAK_BACKEND_LANE64
+#endif
+
+// Share-major backend only: 1 = Thumb-2 assembly (masked_keccak_asm.s,
+// Cortex-M4 builds), checked against the C round at start-up,
+// 0 = C keccak_linear_layer() and Chi. At MASKING_ORDER 1 to 3 with the
+// ISW-style gadgets and MASKED_IOTA_REMASK=0 the whole permutation runs in
+// assembly; otherwise only Theta/Rho/Pi does. Give the assembler the same
+// options as the compiler.
+#ifndef MASKED_KECCAK_ASM
+#define MASKED_KECCAK_ASM 0
+#endif
+
+#if MASKED_KECCAK_ASM && MASKED_KECCAK_BACKEND != KECCAK_BACKEND_SOA
+#error "MASKED_KECCAK_ASM needs the share-major backend, build it with MASKED_KECCAK_BACKEND=2"
+#endif
+
+#if MASKED_TI && MASKED_KECCAK_BACKEND == KECCAK_BACKEND_LANECOMP
+#error "The 3-share TI Chi has no lane-complementing variant"
+#endif
+
+#if MASKED_TI && MASKED_KECCAK_BACKEND == KECCAK_BACKEND_HOST_SIMD
+#error "The 3-share TI Chi has no host SIMD variant"
+#endif
+
+// Iota: 0 = XOR the round constant into share 0 (no randomness),
+//       1 = legacy recombine-and-remask of lane (0,0), kept for comparison
+#ifndef MASKED_IOTA_REMASK
+#define MASKED_IOTA_REMASK 0
+#endif
+
+// Derived: the permutation runs in masked_soa_keccak_p1600_asm().
+#define MASKED_KECCAK_ASM_ROUND (MASKED_KECCAK_ASM && !MASKED_TI && !MASKED_IOTA_REMASK && \
+                                 MASKING_ORDER <= 3)
+
+// Chi randomness (see chi_row_random() in masked_gadgets.c):
+//   MASKED_CHI_ISW      = fresh N(N-1)/2-word matrix for each of the 5 ANDs of a row
+//   MASKED_CHI_RECYCLED = one fresh matrix per row, reused by the 5 ANDs at
+//                         distinct bit rotations (5x less Chi randomness);
+//                         first order only
+#define MASKED_CHI_ISW       0
+#define MASKED_CHI_RECYCLED  1
+
+#ifndef MASKED_CHI_GADGET
+#define MASKED_CHI_GADGET MASKED_CHI_ISW
+#endif
+
+#if MASKED_CHI_GADGET == MASKED_CHI_RECYCLED && MASKING_ORDER != 1
+#error "The recycled Chi randomness is only first-order secure, build it with MASKING_ORDER=1"
+#endif
+
+// Gadgets: 1 = fully unrolled masked_and / masked_xor for MASKING_N 2..5,
+//          0 = generic share loops (always used above 5 shares)
+#ifndef MASKED_UNROLLED_GADGETS
+#define MASKED_UNROLLED_GADGETS 1
+#endif
+
+// Randomness source: 1 = interrupt-fed word pool (rng_pool.c),
+//                    0 = blocking HAL_RNG_GenerateRandomNumber() per word
+#ifndef MASKED_RNG_POOL
+#define MASKED_RNG_POOL 1
+#endif
+
+// Entropy source behind get_trng64() and the host pool (rng_source.h):
+//   RNG_SOURCE_HAL           = STM32 hardware RNG, polled (rng_source_hal.c)
+//   RNG_SOURCE_GETRANDOM     = Linux getrandom() (Host/rng_source_getrandom.c)
+//   RNG_SOURCE_DETERMINISTIC = splitmix64 stream from MASKED_RNG_SEED
+//                              (rng_source_seeded.c): reproducible runs only,
+//                              the shares are then predictable
+// The interrupt-fed pool on target always reads the hardware RNG.
+#define RNG_SOURCE_HAL            0
+#define RNG_SOURCE_GETRANDOM      1
+#define RNG_SOURCE_DETERMINISTIC  2
+
+#ifndef MASKED_RNG_SOURCE
+#ifdef __arm__
+#define MASKED_RNG_SOURCE RNG_SOURCE_HAL
+#else
+#define MASKED_RNG_SOURCE RNG_SOURCE_GETRANDOM
+#endif
+#endif
+
+#ifndef MASKED_RNG_SEED
+#define MASKED_RNG_SEED 0x0123456789ABCDEFULL
+#endif
+
+#ifndef RNG_POOL_WORDS
+#define RNG_POOL_WORDS 256    // Pool size in 32-bit words, power of two
+#endif
+
+// Masking randomness expander: 1 = get_random64() reads a ChaCha PRG that is
+// reseeded from the TRNG (masked_prg.c), 0 = every word comes from the TRNG
+#ifndef MASKED_RNG_PRG
+#define MASKED_RNG_PRG 0
+#endif
+
+#ifndef MASKED_PRG_ROUNDS
+#define MASKED_PRG_ROUNDS 8            // ChaCha rounds per block (8, 12 or 20)
+#endif
+
+#ifndef MASKED_PRG_RESEED_BLOCKS
+#define MASKED_PRG_RESEED_BLOCKS 64    // 64-byte blocks generated per TRNG seed
+#endif
+
+// Memory placement: 1 = hash workspace, randomness pool / PRG state and the
+// masked_crypto_call() stack in the 64 KB CCM RAM (zero wait states, CPU
+// only, off the bus matrix shared with USB and DMA), 0 = everything in SRAM.
+// CCM is not reachable by DMA: never place DMA or USB buffers there.
+#ifndef MASKED_CCM_PLACEMENT
+#define MASKED_CCM_PLACEMENT 0
+#endif
+
+// Zero-initialised object in CCM RAM (.ccmbss, cleared by the startup code).
+#if MASKED_CCM_PLACEMENT && defined(__arm__)
+#define MASKED_CCM_BSS __attribute__((section(".ccmbss")))
+#else
+#define MASKED_CCM_BSS
+#endif
+
+// Code placement: 1 = permutation, gadgets, sponge and randomness kernels in
+// .RamFunc (copied to SRAM with .data at reset, run without flash wait
+// states or ART cache misses), 0 = execute in place from flash.
+// CCM is on the D-bus only and cannot hold code. Calls between flash and
+// RAM go through linker veneers; the Thumb-2 linear layer stays in flash.
+#ifndef MASKED_RAM_FUNCTIONS
+#define MASKED_RAM_FUNCTIONS 0
+#endif
+
+#if MASKED_RAM_FUNCTIONS && defined(__arm__)
+#define MASKED_RAMFUNC __attribute__((section(".RamFunc")))
+#else
+#define MASKED_RAMFUNC
+#endif
+
 #endif // PARAMS_H
@@ -0,0 +1,78 @@
+#include "rng_pool.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if (RNG_POOL_WORDS & (RNG_POOL_WORDS - 1)) != 0
+#error "RNG_POOL_WORDS must be a power of two"
+#endif
+
+// Single-producer/single-consumer ring. head is only written by the
+// producer (interrupt), tail only by the consumer, so no locking is needed;
+// head - tail is the fill level even across 32-bit wrap-around.
+static volatile uint32_t rng_pool_buf[RNG_POOL_WORDS] MASKED_CCM_BSS;
+static volatile uint32_t rng_pool_head;
+static volatile uint32_t rng_pool_tail;
+
+// Set while a word has been requested from the port and not yet delivered.
+static volatile uint8_t rng_pool_refilling;
+
+//Restart the refill chain if the producer has stopped.
+static void rng_pool_kick(void) {
+    if (!rng_pool_refilling) {
+        rng_pool_refilling = 1;
+        rng_pool_port_start();
+    }
+}
+
+void rng_pool_init(void) {
+    for (size_t i = 0; i < RNG_POOL_WORDS; i++)
+        rng_pool_buf[i] = 0;
+    rng_pool_tail = rng_pool_head;
+    rng_pool_kick();
+}
+
+size_t rng_pool_available(void) {
+    return (size_t)(rng_pool_head - rng_pool_tail);
+}
+
+void rng_pool_on_word(uint32_t word) {
+    uint32_t head = rng_pool_head;
+
+    if (head - rng_pool_tail < RNG_POOL_WORDS) {
+        rng_pool_buf[head & (RNG_POOL_WORDS - 1)] = word;
+        rng_pool_head = head + 1;
+    }
+
+    // Keep going while there is room; otherwise the next pop restarts us.
+    if (rng_pool_head - rng_pool_tail < RNG_POOL_WORDS) {
+        rng_pool_port_start();
+    } else {
+        rng_pool_refilling = 0;
+    }
+}
+
+/**
+ * Take one 32-bit random word from the pool.
+ *
+ * The slot is cleared after reading so used mask material does not stay
+ * in RAM. If the pool has run dry the caller waits for the producer.
+ */
+MASKED_RAMFUNC uint32_t rng_pool_get32(void) {
+    while (rng_pool_head == rng_pool_tail) {
+        rng_pool_kick();
+        rng_pool_port_wait();
+    }
+
+    uint32_t tail = rng_pool_tail;
+    uint32_t word = rng_pool_buf[tail & (RNG_POOL_WORDS - 1)];
+    rng_pool_buf[tail & (RNG_POOL_WORDS - 1)] = 0;
+    rng_pool_tail = tail + 1;
+
+    rng_pool_kick();
+    return word;
+}
+
+MASKED_RAMFUNC uint64_t rng_pool_get64(void) {
+    uint64_t hi = rng_pool_get32();
+    return (hi << 32) | rng_pool_get32();
+}
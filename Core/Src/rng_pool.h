@@ -0,0 +1,36 @@
+#ifndef RNG_POOL_H
+#define RNG_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "params.h"
+
+// Background-filled pool of 32-bit random words.
+//
+// A single producer (the RNG data-ready interrupt on target, a simulated
+// interrupt on the host) pushes words into a ring buffer, and the masking
+// code pops them with no peripheral access. The producer re-arms itself
+// while there is space and stops when the ring is full; the next pop
+// restarts it.
+
+// Reset the pool and start the background refill.
+void rng_pool_init(void);
+
+// Number of words currently buffered.
+size_t rng_pool_available(void);
+
+// Take one 32-bit / 64-bit random value, waiting if the pool is empty.
+uint32_t rng_pool_get32(void);
+uint64_t rng_pool_get64(void);
+
+// Producer side: hand one fresh word to the pool. Called from the
+// data-ready interrupt; re-arms the port while the ring has space.
+void rng_pool_on_word(uint32_t word);
+
+// === Port hooks (rng_pool_hal.c on target, Host/rng_pool_host.c on Linux) ===
+// Request one more word from the entropy source, delivered later via rng_pool_on_word().
+void rng_pool_port_start(void);
+// Called by a consumer that found the pool empty.
+void rng_pool_port_wait(void);
+
+#endif // RNG_POOL_H
@@ -0,0 +1,39 @@
+#include "rng_pool.h"
+#include "stm32f4xx_hal.h"
+
+extern RNG_HandleTypeDef hrng;
+
+// STM32 port of the randomness pool: the RNG data-ready interrupt
+// (HASH_RNG_IRQHandler -> HAL_RNG_IRQHandler) delivers one word per
+// HAL_RNG_GenerateRandomNumber_IT() request.
+
+void rng_pool_port_start(void) {
+    HAL_RNG_GenerateRandomNumber_IT(&hrng);
+}
+
+void rng_pool_port_wait(void) {
+    // The interrupt fills the pool; nothing to do but let it run.
+}
+
+void HAL_RNG_ReadyDataCallback(RNG_HandleTypeDef *h, uint32_t random32bit) {
+    if (h == &hrng) {
+        rng_pool_on_word(random32bit);
+    }
+}
+
+/**
+ * Recover from an RNG seed or clock error.
+ *
+ * The HAL leaves the handle in the error state, which would stall the
+ * pool for good. Restart the generator (RM0090 seed-error procedure)
+ * and request the next word again.
+ */
+void HAL_RNG_ErrorCallback(RNG_HandleTypeDef *h) {
+    if (h == &hrng) {
+        __HAL_RNG_DISABLE(h);
+        __HAL_RNG_ENABLE(h);
+        h->State = HAL_RNG_STATE_READY;
+        __HAL_UNLOCK(h);
+        HAL_RNG_GenerateRandomNumber_IT(h);
+    }
+}
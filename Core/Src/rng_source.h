@@ -0,0 +1,20 @@
+#ifndef RNG_SOURCE_H
+#define RNG_SOURCE_H
+
+#include <stdint.h>
+#include "params.h"
+
+// Randomness provider behind get_trng64() and the host pool port.
+//
+// One backend is compiled in, picked by MASKED_RNG_SOURCE: the STM32
+// hardware RNG (rng_source_hal.c), Linux getrandom()
+// (Host/rng_source_getrandom.c) or a seeded deterministic stream for
+// reproducible tests (rng_source_seeded.c). The other files build empty.
+
+// One 32-bit word from the selected source, waiting until one is ready.
+uint32_t rng_source_word(void);
+
+// Restart the deterministic stream from seed. No effect on the entropy sources.
+void rng_source_seed(uint64_t seed);
+
+#endif // RNG_SOURCE_H
@@ -0,0 +1,19 @@
+#include "rng_source.h"
+
+#if MASKED_RNG_SOURCE == RNG_SOURCE_HAL
+#include "stm32f4xx_hal.h"
+
+extern RNG_HandleTypeDef hrng;
+
+// STM32 hardware RNG, polled: retry until the HAL reports a valid word
+// (it returns an error while the next word is not ready or on a seed error).
+uint32_t rng_source_word(void) {
+    uint32_t word;
+    while (HAL_RNG_GenerateRandomNumber(&hrng, &word) != HAL_OK) {}
+    return word;
+}
+
+void rng_source_seed(uint64_t seed) {
+    (void)seed;
+}
+#endif
@@ -0,0 +1,36 @@
+#include "rng_source.h"
+
+#if MASKED_RNG_SOURCE == RNG_SOURCE_DETERMINISTIC
+// Deterministic stand-in for the entropy source: a splitmix64 stream
+// started from MASKED_RNG_SEED, so the same build draws the same shares on
+// every run. For reproducible tests and benchmarks only; masking with
+// predictable randomness protects nothing.
+
+static uint64_t rng_source_state = MASKED_RNG_SEED;
+static uint32_t rng_source_spare;
+static int rng_source_has_spare;
+
+static uint64_t splitmix64(void) {
+    uint64_t z = (rng_source_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Both halves of each 64-bit output are used, high half first.
+uint32_t rng_source_word(void) {
+    if (rng_source_has_spare) {
+        rng_source_has_spare = 0;
+        return rng_source_spare;
+    }
+    uint64_t z = splitmix64();
+    rng_source_spare = (uint32_t)z;
+    rng_source_has_spare = 1;
+    return (uint32_t)(z >> 32);
+}
+
+void rng_source_seed(uint64_t seed) {
+    rng_source_state = seed;
+    rng_source_has_spare = 0;
+}
+#endif
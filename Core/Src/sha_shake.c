@@ -1,72 +1,254 @@
 #include "sha_shake.h"
 #include "masked_keccak.h"
+#include "masked_gadgets.h"
 #include <string.h>
 #include "params.h"
 
-// === Public API Implementations ===
-void masked_keccak_sponge(uint8_t *output, size_t output_len,
-                          const uint8_t *input, size_t input_len,
-                          size_t rate, uint8_t domain_sep) {
-    masked_uint64_t state[5][5];
+//======Segment Absorb Helpers======
 
-    //Step 1: Initialize state
-    for (int x = 0; x < 5; x++) {
-        for (int y = 0; y < 5; y++) {
-            for (int i = 0; i < MASKING_N; i++) {
-                state[x][y].share[i] = 0;
+//Mask the pending secret bytes of the current lane and XOR them into the state.
+static MASKED_RAMFUNC void absorb_flush_lane(masked_uint64_t state[5][5], masked_absorb_cursor_t *cur, size_t lane_index) {
+    if (cur->lane_has_secret) {
+        masked_uint64_t masked_lane;
+        masked_value_set(&masked_lane, cur->secret_lane);
+        masked_xor(&state[lane_index % 5][lane_index / 5],
+                   &state[lane_index % 5][lane_index / 5], &masked_lane);
+    }
+    cur->secret_lane = 0;
+    cur->lane_has_secret = 0;
+}
+
+//Absorb segment bytes from offset k until the segment ends or the block is
+// full. Returns the new offset; the caller runs the permutation.
+static MASKED_RAMFUNC size_t absorb_block(masked_uint64_t state[5][5], masked_absorb_cursor_t *cur,
+                                          const masked_input_segment_t *seg, size_t k, size_t rate) {
+    while (k < seg->len && cur->pos < rate) {
+        size_t lane_index = cur->pos / 8;
+        unsigned int shift = 8 * (cur->pos % 8);
+        masked_uint64_t *lane = &state[lane_index % 5][lane_index / 5];
+
+        if (seg->sensitivity == MASKED_INPUT_SHARED_LANES &&
+            shift == 0 && k % 8 == 0 && seg->len - k >= 8) {
+            // Aligned whole lane: XOR share-wise in one go.
+            masked_xor(lane, lane, &seg->lanes[k / 8]);
+            k += 8;
+            cur->pos += 8;
+        } else {
+            switch (seg->sensitivity) {
+            case MASKED_INPUT_PUBLIC:
+                // Public data: XOR into one share, no randomness needed.
+                lane->share[0] ^= (uint64_t)seg->data[k] << shift;
+                break;
+            case MASKED_INPUT_SHARED_BYTES:
+                for (int i = 0; i < MASKING_N; i++)
+                    lane->share[i] ^= (uint64_t)seg->shares[i][k] << shift;
+                break;
+            case MASKED_INPUT_SHARED_LANES:
+                for (int i = 0; i < MASKING_N; i++)
+                    lane->share[i] ^= ((seg->lanes[k / 8].share[i] >> (8 * (k % 8))) & 0xFF) << shift;
+                break;
+            default:
+                cur->secret_lane |= (uint64_t)seg->data[k] << shift;
+                cur->lane_has_secret = 1;
+                break;
             }
+            k++;
+            cur->pos++;
         }
+
+        if (cur->pos % 8 == 0)
+            absorb_flush_lane(state, cur, lane_index);
     }
+    return k;
+}
 
-    //Step 2: Absorb full input blocks
-    size_t offset = 0;
-    while (input_len >= rate) {
-        for (int i = 0; i < rate; i += 8) {
-            uint64_t lane = 0;
-            for (int j = 0; j < 8; j++) {
-                lane |= ((uint64_t)input[offset + i + j]) << (8 * j);
-            }
+//Run the permutation, with its buffers in scratch if the caller gave one.
+static MASKED_RAMFUNC void sponge_permute(masked_uint64_t state[5][5], int nrounds, masked_keccak_scratch_t *scratch) {
+    if (scratch)
+        masked_keccak_p1600_ws(state, nrounds, scratch);
+    else
+        masked_keccak_p1600(state, nrounds);
+}
 
-            size_t x = (i / 8) % 5;
-            size_t y = (i / 8) / 5;
+//Absorb one segment, permuting whenever a full block has been taken in.
+static MASKED_RAMFUNC void absorb_segment(masked_uint64_t state[5][5], masked_absorb_cursor_t *cur,
+                                          const masked_input_segment_t *seg, size_t rate, int nrounds,
+                                          masked_keccak_scratch_t *scratch) {
+    size_t k = 0;
 
-            masked_uint64_t masked_lane;
-            masked_value_set(&masked_lane, lane);
-            masked_xor(&state[x][y], &state[x][y], &masked_lane);
-        }
+    while (k < seg->len) {
+        k = absorb_block(state, cur, seg, k, rate);
 
-        masked_keccak_f1600(state);
-        offset += rate;
-        input_len -= rate;
+        if (cur->pos == rate) {
+            sponge_permute(state, nrounds, scratch);
+            cur->pos = 0;
+        }
     }
+}
 
-    //Step 3: Final padded block with domain separation
-    uint8_t block[rate];
-    memset(block, 0, rate);
-    memcpy(block, input + offset, input_len);
-    block[input_len] ^= domain_sep;   // Domain separation marker (e.g., 0x06 or 0x1F)
-    block[rate - 1] ^= 0x80;          // Padding rule per Keccak spec
-
-    for (int i = 0; i < rate; i += 8) {
-        uint64_t lane = 0;
-        for (int j = 0; j < 8 && (i + j) < rate; j++) {
-            lane |= ((uint64_t)block[i + j]) << (8 * j);
-        }
+//Mask the last partial lane, then add domain separation and padding.
+// Padding is public, so it only touches share 0. The caller permutes.
+static MASKED_RAMFUNC void absorb_pad_block(masked_uint64_t state[5][5], masked_absorb_cursor_t *cur,
+                                            size_t rate, uint8_t domain_sep) {
+    absorb_flush_lane(state, cur, cur->pos / 8);
+    state[(cur->pos / 8) % 5][(cur->pos / 8) / 5].share[0] ^= (uint64_t)domain_sep << (8 * (cur->pos % 8));
+    state[((rate - 1) / 8) % 5][((rate - 1) / 8) / 5].share[0] ^= 0x80ULL << (8 * ((rate - 1) % 8));
+    cur->pos = 0;
+}
 
-        size_t x = (i / 8) % 5;
-        size_t y = (i / 8) / 5;
+//Pad and run the final absorb permutation.
+static MASKED_RAMFUNC void absorb_pad(masked_uint64_t state[5][5], masked_absorb_cursor_t *cur,
+                                      size_t rate, uint8_t domain_sep, int nrounds,
+                                      masked_keccak_scratch_t *scratch) {
+    absorb_pad_block(state, cur, rate, domain_sep);
+    sponge_permute(state, nrounds, scratch);
+}
 
-        masked_uint64_t masked_lane;
-        masked_value_set(&masked_lane, lane);
-        masked_xor(&state[x][y], &state[x][y], &masked_lane);
+// === Public API Implementations ===
+void masked_keccak_absorb_segments(masked_uint64_t state[5][5],
+                                   const masked_input_segment_t *segments,
+                                   size_t n_segments,
+                                   size_t rate, uint8_t domain_sep) {
+    masked_absorb_cursor_t cur = { 0, 0, 0 };
+
+    //Step 1: Initialize state
+    masked_keccak_state_init(state);
+
+    //Step 2: Absorb every segment, block by block
+    for (size_t n = 0; n < n_segments; n++) {
+        absorb_segment(state, &cur, &segments[n], rate, NROUNDS, NULL);
     }
 
-    masked_keccak_f1600(state);
+    //Step 3: Pad and run the final permutation
+    absorb_pad(state, &cur, rate, domain_sep, NROUNDS, NULL);
+}
+
+void masked_keccak_sponge_segments(uint8_t *output, size_t output_len,
+                                   const masked_input_segment_t *segments,
+                                   size_t n_segments,
+                                   size_t rate, uint8_t domain_sep) {
+    masked_uint64_t state[5][5];
+
+    masked_keccak_absorb_segments(state, segments, n_segments, rate, domain_sep);
 
     //Step 4: Squeeze the requested output
     masked_squeeze(output, output_len, state, rate);
 }
 
+void masked_keccak_sponge(uint8_t *output, size_t output_len,
+                          const uint8_t *input, size_t input_len,
+                          size_t rate, uint8_t domain_sep) {
+    // The whole message is treated as secret.
+    masked_input_segment_t segment = { input, input_len, MASKED_INPUT_SECRET };
+    masked_keccak_sponge_segments(output, output_len, &segment, 1, rate, domain_sep);
+}
+
+
+//Single-segment sponge over pre-shared lanes.
+static void masked_keccak_sponge_shared(uint8_t *output, size_t output_len,
+                                        const masked_uint64_t *lanes, size_t input_len,
+                                        size_t rate, uint8_t domain_sep) {
+    masked_input_segment_t segment = { 0 };
+    segment.len = input_len;
+    segment.sensitivity = MASKED_INPUT_SHARED_LANES;
+    segment.lanes = lanes;
+    masked_keccak_sponge_segments(output, output_len, &segment, 1, rate, domain_sep);
+}
+
+//Single-segment sponge over secret bytes that keeps the output masked.
+static void masked_keccak_sponge_to_shares(masked_uint64_t *output, size_t output_len,
+                                           const uint8_t *input, size_t input_len,
+                                           size_t rate, uint8_t domain_sep) {
+    masked_uint64_t state[5][5];
+    masked_input_segment_t segment = { input, input_len, MASKED_INPUT_SECRET };
+
+    masked_keccak_absorb_segments(state, &segment, 1, rate, domain_sep);
+    masked_squeeze_lanes(output, output_len, state, rate);
+}
+
+// === Streaming Context ===
+void masked_keccak_init(masked_keccak_ctx *ctx, size_t rate, uint8_t domain_sep) {
+    masked_keccak_init_rounds(ctx, rate, domain_sep, NROUNDS);
+}
+
+void masked_keccak_init_rounds(masked_keccak_ctx *ctx, size_t rate, uint8_t domain_sep, int nrounds) {
+    masked_keccak_state_init(ctx->state);
+
+    ctx->cur.pos = 0;
+    ctx->cur.secret_lane = 0;
+    ctx->cur.lane_has_secret = 0;
+    ctx->rate = rate;
+    ctx->domain_sep = domain_sep;
+    ctx->nrounds = nrounds;
+    ctx->squeezing = 0;
+    ctx->scratch = NULL;
+}
+
+void masked_keccak_init_ws(masked_keccak_workspace_t *ws, size_t rate, uint8_t domain_sep) {
+    masked_keccak_init_rounds_ws(ws, rate, domain_sep, NROUNDS);
+}
+
+void masked_keccak_init_rounds_ws(masked_keccak_workspace_t *ws, size_t rate, uint8_t domain_sep, int nrounds) {
+    masked_keccak_init_rounds(&ws->ctx, rate, domain_sep, nrounds);
+    ws->ctx.scratch = &ws->scratch;
+}
+
+void masked_keccak_absorb_segment(masked_keccak_ctx *ctx, const masked_input_segment_t *segment) {
+    absorb_segment(ctx->state, &ctx->cur, segment, ctx->rate, ctx->nrounds, ctx->scratch);
+}
+
+void masked_keccak_absorb(masked_keccak_ctx *ctx, const uint8_t *input, size_t input_len) {
+    masked_input_segment_t segment = { input, input_len, MASKED_INPUT_SECRET };
+    absorb_segment(ctx->state, &ctx->cur, &segment, ctx->rate, ctx->nrounds, ctx->scratch);
+}
+
+void masked_keccak_absorb_public(masked_keccak_ctx *ctx, const uint8_t *input, size_t input_len) {
+    masked_input_segment_t segment = { input, input_len, MASKED_INPUT_PUBLIC };
+    absorb_segment(ctx->state, &ctx->cur, &segment, ctx->rate, ctx->nrounds, ctx->scratch);
+}
+
+void masked_keccak_finalize(masked_keccak_ctx *ctx) {
+    absorb_pad(ctx->state, &ctx->cur, ctx->rate, ctx->domain_sep, ctx->nrounds, ctx->scratch);
+    // From here on cur.pos counts output bytes already taken from the block.
+    ctx->squeezing = 1;
+}
+
+MASKED_RAMFUNC void masked_keccak_squeeze(masked_keccak_ctx *ctx, uint8_t *output, size_t output_len) {
+    size_t offset = 0;
+
+    if (!ctx->squeezing)
+        masked_keccak_finalize(ctx);
+
+    while (offset < output_len) {
+        if (ctx->cur.pos == ctx->rate) {
+            sponge_permute(ctx->state, ctx->nrounds, ctx->scratch);
+            ctx->cur.pos = 0;
+        }
+
+        // Recombine the lane once, then copy out as many of its bytes as needed.
+        size_t lane_index = ctx->cur.pos / 8;
+        size_t byte = ctx->cur.pos % 8;
+        const masked_uint64_t *lane = &ctx->state[lane_index % 5][lane_index / 5];
+        uint64_t value = keccak_lane_complement(lane_index % 5, lane_index / 5);
+        for (int j = 0; j < MASKING_N; j++)
+            value ^= lane->share[j];
+
+        for (; byte < 8 && offset < output_len; byte++) {
+            output[offset++] = (uint8_t)(value >> (8 * byte));
+            ctx->cur.pos++;
+        }
+    }
+}
+
+void masked_keccak_clone(masked_keccak_ctx *dst, const masked_keccak_ctx *src, int refresh) {
+    *dst = *src;
+
+    if (refresh) {
+        for (int x = 0; x < 5; x++)
+            for (int y = 0; y < 5; y++)
+                masked_refresh(&dst->state[x][y]);
+    }
+}
 
 // SHA3-224: 28-byte output, 1152-bit rate
 void masked_sha3_224(uint8_t *output, const uint8_t *input, size_t input_len) {
@@ -97,3 +279,381 @@ void masked_shake128(uint8_t *output, size_t output_len, const uint8_t *input, s
 void masked_shake256(uint8_t *output, size_t output_len, const uint8_t *input, size_t input_len) {
     masked_keccak_sponge(output, output_len, input, input_len, 136, DOMAIN_SHAKE);
 }
+
+//Secret-input sponge on the caller's workspace; see masked_keccak_workspace_t.
+static void masked_keccak_sponge_ws(masked_keccak_workspace_t *ws,
+                                    uint8_t *output, size_t output_len,
+                                    const uint8_t *input, size_t input_len,
+                                    size_t rate, uint8_t domain_sep) {
+    masked_keccak_init_ws(ws, rate, domain_sep);
+    masked_keccak_absorb(&ws->ctx, input, input_len);
+    masked_keccak_squeeze(&ws->ctx, output, output_len);
+}
+
+void masked_sha3_224_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                        const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_ws(ws, output, 28, input, input_len, 1152 / 8, DOMAIN_SHA3);
+}
+
+void masked_sha3_256_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                        const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_ws(ws, output, 32, input, input_len, 136, DOMAIN_SHA3);
+}
+
+void masked_sha3_384_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                        const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_ws(ws, output, 48, input, input_len, 832 / 8, DOMAIN_SHA3);
+}
+
+void masked_sha3_512_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                        const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_ws(ws, output, 64, input, input_len, 72, DOMAIN_SHA3);
+}
+
+void masked_shake128_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                        const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_ws(ws, output, output_len, input, input_len, 168, DOMAIN_SHAKE);
+}
+
+void masked_shake256_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                        const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_ws(ws, output, output_len, input, input_len, 136, DOMAIN_SHAKE);
+}
+
+//Pre-shared input sponge on the caller's workspace.
+static void masked_keccak_sponge_shared_ws(masked_keccak_workspace_t *ws,
+                                           uint8_t *output, size_t output_len,
+                                           const masked_uint64_t *lanes, size_t input_len,
+                                           size_t rate, uint8_t domain_sep) {
+    masked_input_segment_t segment = { 0 };
+    segment.len = input_len;
+    segment.sensitivity = MASKED_INPUT_SHARED_LANES;
+    segment.lanes = lanes;
+
+    masked_keccak_init_ws(ws, rate, domain_sep);
+    masked_keccak_absorb_segment(&ws->ctx, &segment);
+    masked_keccak_squeeze(&ws->ctx, output, output_len);
+}
+
+//Secret-input sponge on the caller's workspace that keeps the output masked.
+// Squeezes one block at a time, so masked_squeeze_lanes() never permutes
+// on the stack; the permutations in between use ws->scratch.
+static void masked_keccak_sponge_to_shares_ws(masked_keccak_workspace_t *ws,
+                                              masked_uint64_t *output, size_t output_len,
+                                              const uint8_t *input, size_t input_len,
+                                              size_t rate, uint8_t domain_sep) {
+    size_t offset = 0;
+
+    masked_keccak_init_ws(ws, rate, domain_sep);
+    masked_keccak_absorb(&ws->ctx, input, input_len);
+    masked_keccak_finalize(&ws->ctx);
+
+    while (offset < output_len) {
+        size_t len = output_len - offset < rate ? output_len - offset : rate;
+        masked_squeeze_lanes(output + offset / 8, len, ws->ctx.state, rate);
+        offset += len;
+
+        if (offset < output_len)
+            sponge_permute(ws->ctx.state, ws->ctx.nrounds, ws->ctx.scratch);
+    }
+}
+
+void masked_sha3_256_shared_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                               const masked_uint64_t *lanes, size_t input_len) {
+    masked_keccak_sponge_shared_ws(ws, output, 32, lanes, input_len, 136, DOMAIN_SHA3);
+}
+
+void masked_sha3_512_shared_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                               const masked_uint64_t *lanes, size_t input_len) {
+    masked_keccak_sponge_shared_ws(ws, output, 64, lanes, input_len, 72, DOMAIN_SHA3);
+}
+
+void masked_shake128_shared_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                               const masked_uint64_t *lanes, size_t input_len) {
+    masked_keccak_sponge_shared_ws(ws, output, output_len, lanes, input_len, 168, DOMAIN_SHAKE);
+}
+
+void masked_shake256_shared_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                               const masked_uint64_t *lanes, size_t input_len) {
+    masked_keccak_sponge_shared_ws(ws, output, output_len, lanes, input_len, 136, DOMAIN_SHAKE);
+}
+
+void masked_sha3_256_to_shares_ws(masked_keccak_workspace_t *ws, masked_uint64_t *output,
+                                  const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_to_shares_ws(ws, output, 32, input, input_len, 136, DOMAIN_SHA3);
+}
+
+void masked_sha3_512_to_shares_ws(masked_keccak_workspace_t *ws, masked_uint64_t *output,
+                                  const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_to_shares_ws(ws, output, 64, input, input_len, 72, DOMAIN_SHA3);
+}
+
+void masked_shake128_to_shares_ws(masked_keccak_workspace_t *ws, masked_uint64_t *output, size_t output_len,
+                                  const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_to_shares_ws(ws, output, output_len, input, input_len, 168, DOMAIN_SHAKE);
+}
+
+void masked_shake256_to_shares_ws(masked_keccak_workspace_t *ws, masked_uint64_t *output, size_t output_len,
+                                  const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_to_shares_ws(ws, output, output_len, input, input_len, 136, DOMAIN_SHAKE);
+}
+
+// Pre-shared input variants: same parameters as above, input given as masked lanes
+void masked_sha3_256_shared(uint8_t *output, const masked_uint64_t *lanes, size_t input_len) {
+    masked_keccak_sponge_shared(output, 32, lanes, input_len, 136, DOMAIN_SHA3);
+}
+
+void masked_sha3_512_shared(uint8_t *output, const masked_uint64_t *lanes, size_t input_len) {
+    masked_keccak_sponge_shared(output, 64, lanes, input_len, 72, DOMAIN_SHA3);
+}
+
+void masked_shake128_shared(uint8_t *output, size_t output_len,
+                            const masked_uint64_t *lanes, size_t input_len) {
+    masked_keccak_sponge_shared(output, output_len, lanes, input_len, 168, DOMAIN_SHAKE);
+}
+
+void masked_shake256_shared(uint8_t *output, size_t output_len,
+                            const masked_uint64_t *lanes, size_t input_len) {
+    masked_keccak_sponge_shared(output, output_len, lanes, input_len, 136, DOMAIN_SHAKE);
+}
+
+// Masked-output variants: same parameters as above, output left as masked lanes
+void masked_sha3_256_to_shares(masked_uint64_t *output, const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_to_shares(output, 32, input, input_len, 136, DOMAIN_SHA3);
+}
+
+void masked_sha3_512_to_shares(masked_uint64_t *output, const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_to_shares(output, 64, input, input_len, 72, DOMAIN_SHA3);
+}
+
+void masked_shake128_to_shares(masked_uint64_t *output, size_t output_len,
+                               const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_to_shares(output, output_len, input, input_len, 168, DOMAIN_SHAKE);
+}
+
+void masked_shake256_to_shares(masked_uint64_t *output, size_t output_len,
+                               const uint8_t *input, size_t input_len) {
+    masked_keccak_sponge_to_shares(output, output_len, input, input_len, 136, DOMAIN_SHAKE);
+}
+
+// === Batched Sponge (x4) ===
+
+//Sponge over four equal-length secret messages, one permutation call per
+// block for all four states.
+static void masked_keccak_sponge_x4(uint8_t *const output[4], size_t output_len,
+                                    const uint8_t *const input[4], size_t input_len,
+                                    size_t rate, uint8_t domain_sep) {
+    masked_uint64_t state[4][5][5];
+    masked_absorb_cursor_t cur[4];
+    size_t k = 0, offset = 0;
+
+    for (int n = 0; n < 4; n++) {
+        masked_keccak_state_init(state[n]);
+        cur[n] = (masked_absorb_cursor_t){ 0, 0, 0 };
+    }
+
+    // Equal lengths keep the block boundaries of all four messages aligned.
+    for (;;) {
+        size_t next = k;
+        for (int n = 0; n < 4; n++) {
+            masked_input_segment_t segment = { input[n], input_len, MASKED_INPUT_SECRET };
+            next = absorb_block(state[n], &cur[n], &segment, k, rate);
+        }
+        k = next;
+
+        if (cur[0].pos < rate)
+            break;
+        masked_keccak_p1600_x4(state, NROUNDS);
+        for (int n = 0; n < 4; n++)
+            cur[n].pos = 0;
+    }
+
+    for (int n = 0; n < 4; n++)
+        absorb_pad_block(state[n], &cur[n], rate, domain_sep);
+    masked_keccak_p1600_x4(state, NROUNDS);
+
+    while (offset < output_len) {
+        size_t len = output_len - offset < rate ? output_len - offset : rate;
+        for (int n = 0; n < 4; n++)
+            masked_squeeze(output[n] + offset, len, state[n], rate);
+        offset += len;
+
+        if (offset < output_len)
+            masked_keccak_p1600_x4(state, NROUNDS);
+    }
+}
+
+void masked_sha3_256_x4(uint8_t *const output[4], const uint8_t *const input[4], size_t input_len) {
+    masked_keccak_sponge_x4(output, 32, input, input_len, 136, DOMAIN_SHA3);
+}
+
+void masked_sha3_512_x4(uint8_t *const output[4], const uint8_t *const input[4], size_t input_len) {
+    masked_keccak_sponge_x4(output, 64, input, input_len, 72, DOMAIN_SHA3);
+}
+
+void masked_shake128_x4(uint8_t *const output[4], size_t output_len,
+                        const uint8_t *const input[4], size_t input_len) {
+    masked_keccak_sponge_x4(output, output_len, input, input_len, 168, DOMAIN_SHAKE);
+}
+
+void masked_shake256_x4(uint8_t *const output[4], size_t output_len,
+                        const uint8_t *const input[4], size_t input_len) {
+    masked_keccak_sponge_x4(output, output_len, input, input_len, 136, DOMAIN_SHAKE);
+}
+
+// === TurboSHAKE / KangarooTwelve ===
+
+//TurboSHAKE: SHAKE-style sponge over 12-round Keccak-p, caller-chosen domain byte.
+static void masked_turboshake(uint8_t *output, size_t output_len,
+                              const uint8_t *input, size_t input_len,
+                              size_t rate, uint8_t domain_sep) {
+    masked_keccak_ctx ctx;
+
+    masked_keccak_init_rounds(&ctx, rate, domain_sep, TURBOSHAKE_ROUNDS);
+    masked_keccak_absorb(&ctx, input, input_len);
+    masked_keccak_squeeze(&ctx, output, output_len);
+}
+
+// TurboSHAKE128: Rate = 168 bytes, domain byte D in 0x01..0x7F
+void masked_turboshake128(uint8_t *output, size_t output_len,
+                          const uint8_t *input, size_t input_len, uint8_t domain_sep) {
+    masked_turboshake(output, output_len, input, input_len, 168, domain_sep);
+}
+
+// TurboSHAKE256: Rate = 136 bytes, domain byte D in 0x01..0x7F
+void masked_turboshake256(uint8_t *output, size_t output_len,
+                          const uint8_t *input, size_t input_len, uint8_t domain_sep) {
+    masked_turboshake(output, output_len, input, input_len, 136, domain_sep);
+}
+
+//TurboSHAKE on the caller's workspace.
+static void masked_turboshake_ws(masked_keccak_workspace_t *ws,
+                                 uint8_t *output, size_t output_len,
+                                 const uint8_t *input, size_t input_len,
+                                 size_t rate, uint8_t domain_sep) {
+    masked_keccak_init_rounds_ws(ws, rate, domain_sep, TURBOSHAKE_ROUNDS);
+    masked_keccak_absorb(&ws->ctx, input, input_len);
+    masked_keccak_squeeze(&ws->ctx, output, output_len);
+}
+
+void masked_turboshake128_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                             const uint8_t *input, size_t input_len, uint8_t domain_sep) {
+    masked_turboshake_ws(ws, output, output_len, input, input_len, 168, domain_sep);
+}
+
+void masked_turboshake256_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                             const uint8_t *input, size_t input_len, uint8_t domain_sep) {
+    masked_turboshake_ws(ws, output, output_len, input, input_len, 136, domain_sep);
+}
+
+//length_encode(x) of KangarooTwelve: big-endian x without leading zeros, then its byte count.
+static size_t k12_length_encode(uint8_t out[9], size_t x) {
+    size_t n = 0;
+
+    for (size_t v = x; v > 0; v >>= 8)
+        n++;
+    for (size_t i = 0; i < n; i++)
+        out[i] = (uint8_t)(x >> (8 * (n - 1 - i)));
+    out[n] = (uint8_t)n;
+    return n + 1;
+}
+
+//Absorb bytes [start, start + len) of the concatenation of the given segments.
+static void k12_absorb_range(masked_keccak_ctx *ctx, const masked_input_segment_t *segments,
+                             size_t n_segments, size_t start, size_t len) {
+    for (size_t n = 0; n < n_segments && len > 0; n++) {
+        const masked_input_segment_t *seg = &segments[n];
+
+        if (start >= seg->len) {
+            start -= seg->len;
+            continue;
+        }
+
+        masked_input_segment_t part = { seg->data + start, seg->len - start, seg->sensitivity };
+        if (part.len > len)
+            part.len = len;
+        masked_keccak_absorb_segment(ctx, &part);
+        len -= part.len;
+        start = 0;
+    }
+}
+
+//Start a 12-round sponge whose permutations use scratch (NULL = on the stack).
+static void k12_init(masked_keccak_ctx *ctx, uint8_t domain_sep, masked_keccak_scratch_t *scratch) {
+    masked_keccak_init_rounds(ctx, 168, domain_sep, TURBOSHAKE_ROUNDS);
+    ctx->scratch = scratch;
+}
+
+//KangarooTwelve over the caller's sponges: final_node, and leaf with its
+// chaining value cv for inputs longer than one chunk. Both share scratch.
+static void kangarootwelve(masked_keccak_ctx *final_node, masked_keccak_ctx *leaf,
+                           masked_uint64_t cv[4], masked_keccak_scratch_t *scratch,
+                           uint8_t *output, size_t output_len,
+                           const uint8_t *input, size_t input_len,
+                           const uint8_t *custom, size_t custom_len) {
+    static const uint8_t k12_final_marker[8] = { 0x03 };
+    static const uint8_t k12_final_end[2] = { 0xFF, 0xFF };
+    uint8_t enc[9];
+
+    // S = M || C || length_encode(|C|); only M is secret.
+    masked_input_segment_t S[3] = {
+        { input, input_len, MASKED_INPUT_SECRET },
+        { custom, custom_len, MASKED_INPUT_PUBLIC },
+        { enc, k12_length_encode(enc, custom_len), MASKED_INPUT_PUBLIC },
+    };
+    size_t s_len = S[0].len + S[1].len + S[2].len;
+
+    if (s_len <= K12_CHUNK_SIZE) {
+        k12_init(final_node, 0x07, scratch);
+        k12_absorb_range(final_node, S, 3, 0, s_len);
+        masked_keccak_squeeze(final_node, output, output_len);
+        return;
+    }
+
+    // Final node: S_0 || 0x03 0^7 || CV_1 .. CV_{n-1} || length_encode(n-1) || 0xFF 0xFF
+    k12_init(final_node, 0x06, scratch);
+    k12_absorb_range(final_node, S, 3, 0, K12_CHUNK_SIZE);
+    masked_keccak_absorb_public(final_node, k12_final_marker, sizeof(k12_final_marker));
+
+    size_t n_leaves = 0;
+    for (size_t start = K12_CHUNK_SIZE; start < s_len; start += K12_CHUNK_SIZE) {
+        masked_input_segment_t cv_segment = { 0 };
+        size_t len = s_len - start;
+
+        if (len > K12_CHUNK_SIZE)
+            len = K12_CHUNK_SIZE;
+
+        // Leaf chaining values stay masked all the way into the final node.
+        k12_init(leaf, 0x0B, scratch);
+        k12_absorb_range(leaf, S, 3, start, len);
+        masked_keccak_finalize(leaf);
+        masked_squeeze_lanes(cv, 32, leaf->state, 168);
+
+        cv_segment.len = 32;
+        cv_segment.sensitivity = MASKED_INPUT_SHARED_LANES;
+        cv_segment.lanes = cv;
+        masked_keccak_absorb_segment(final_node, &cv_segment);
+        n_leaves++;
+    }
+
+    masked_keccak_absorb_public(final_node, enc, k12_length_encode(enc, n_leaves));
+    masked_keccak_absorb_public(final_node, k12_final_end, sizeof(k12_final_end));
+    masked_keccak_squeeze(final_node, output, output_len);
+}
+
+void masked_kangarootwelve(uint8_t *output, size_t output_len,
+                           const uint8_t *input, size_t input_len,
+                           const uint8_t *custom, size_t custom_len) {
+    masked_keccak_ctx final_node, leaf;
+    masked_uint64_t cv[4];
+
+    kangarootwelve(&final_node, &leaf, cv, NULL, output, output_len,
+                   input, input_len, custom, custom_len);
+}
+
+void masked_kangarootwelve_ws(masked_k12_workspace_t *ws, uint8_t *output, size_t output_len,
+                              const uint8_t *input, size_t input_len,
+                              const uint8_t *custom, size_t custom_len) {
+    kangarootwelve(&ws->final_node, &ws->leaf, ws->cv, &ws->scratch, output, output_len,
+                   input, input_len, custom, custom_len);
+}
@@ -1,9 +1,10 @@
-#ifndef MASKED_KECCAK_H
-#define MASKED_KECCAK_H
+#ifndef SHA_SHAKE_H
+#define SHA_SHAKE_H
 
 #include <stddef.h>
 #include <stdint.h>
 #include "masked_types.h"
+#include "masked_keccak.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,6 +30,217 @@ extern "C" {
 void masked_keccak_sponge(uint8_t *output, size_t output_len,
                           const uint8_t *input, size_t input_len,
                           size_t rate, uint8_t domain_sep);
+
+// --- Mixed public/secret input ---
+
+// Whether absorbed bytes must be freshly masked.
+// Public bytes (seeds, domain strings, counters) are XORed into share 0 only
+// and cost no randomness; secret bytes are split into MASKING_N fresh shares.
+// Already-shared input is XORed share-by-share: no recombination and no
+// fresh randomness.
+typedef enum {
+    MASKED_INPUT_SECRET = 0,
+    MASKED_INPUT_PUBLIC = 1,
+    MASKED_INPUT_SHARED_BYTES = 2,  // len bytes in each of shares[0..MASKING_N-1]
+    MASKED_INPUT_SHARED_LANES = 3   // len bytes taken little-endian from lanes[]
+} masked_input_sensitivity_t;
+
+typedef struct {
+    const uint8_t *data;                 // PUBLIC / SECRET input
+    size_t len;                          // Length in bytes for every kind
+    masked_input_sensitivity_t sensitivity;
+    const uint8_t *shares[MASKING_N];    // SHARED_BYTES: one buffer per share
+    const masked_uint64_t *lanes;        // SHARED_LANES: masked 64-bit lanes
+} masked_input_segment_t;
+
+/**
+ * Sponge over the concatenation of several input segments.
+ *
+ * Segments are absorbed back to back exactly as if they were one message,
+ * so the output equals masked_keccak_sponge() on the concatenated bytes.
+ * Only lanes that contain at least one secret byte draw fresh randomness;
+ * padding is public. Which lanes are masked depends only on segment
+ * lengths and flags, never on the data.
+ *
+ * Example, Kyber XOF(rho, i, j) where everything is public:
+ *   masked_input_segment_t in[2] = {
+ *       { rho, 32, MASKED_INPUT_PUBLIC }, { ij, 2, MASKED_INPUT_PUBLIC } };
+ */
+void masked_keccak_sponge_segments(uint8_t *output, size_t output_len,
+                                   const masked_input_segment_t *segments,
+                                   size_t n_segments,
+                                   size_t rate, uint8_t domain_sep);
+
+/**
+ * Absorb phase of masked_keccak_sponge_segments() on its own.
+ *
+ * Initialises state, absorbs the segments, pads and runs the final
+ * permutation. The caller then squeezes with masked_squeeze() for plain
+ * output, or masked_squeeze_lanes() / masked_squeeze_share_bytes() to keep
+ * the output masked.
+ */
+void masked_keccak_absorb_segments(masked_uint64_t state[5][5],
+                                   const masked_input_segment_t *segments,
+                                   size_t n_segments,
+                                   size_t rate, uint8_t domain_sep);
+// --- Streaming (incremental) interface ---
+
+// Running position of the absorb phase within the current block.
+// Secret bytes of the lane being filled are collected in secret_lane and
+// masked once, when the lane is complete or absorption ends.
+typedef struct {
+    size_t pos;             // Byte offset within the current rate-sized block
+    uint64_t secret_lane;   // Pending secret bytes of lane pos / 8
+    int lane_has_secret;    // Set if any byte of that lane came from a secret segment
+} masked_absorb_cursor_t;
+
+// Sponge state for hashing data as it arrives. Partial blocks are kept in
+// the masked state itself, so no extra block buffer is needed; only the
+// pending secret bytes of the current lane are held unmasked (in cur).
+typedef struct masked_keccak_ctx {
+    masked_uint64_t state[5][5];
+    masked_absorb_cursor_t cur;   // Absorb position, then squeeze position
+    size_t rate;                  // Rate in bytes
+    uint8_t domain_sep;
+    int nrounds;                  // Keccak-p rounds per permutation (24 for SHA-3)
+    int squeezing;                // Set once finalised
+    masked_keccak_scratch_t *scratch;  // Permutation buffers, NULL = on the stack
+} masked_keccak_ctx;
+
+/**
+ * Streaming sponge: init, any number of absorb calls of any size,
+ * finalize, then any number of squeeze calls.
+ *
+ * The output equals the one-shot functions on the concatenated input and
+ * the concatenated squeeze requests. Absorbing after finalize is not
+ * allowed; squeezing before finalize finalises first.
+ *
+ * Example, SHAKE128 over data received in chunks:
+ *   masked_keccak_ctx ctx;
+ *   masked_keccak_init(&ctx, 168, DOMAIN_SHAKE);
+ *   while (n = uart_read(buf, sizeof(buf))) masked_keccak_absorb(&ctx, buf, n);
+ *   masked_keccak_finalize(&ctx);
+ *   masked_keccak_squeeze(&ctx, block, 168);   // repeat as needed
+ */
+void masked_keccak_init(masked_keccak_ctx *ctx, size_t rate, uint8_t domain_sep);
+// Same, over Keccak-p[1600, nrounds] (12 for TurboSHAKE / KangarooTwelve).
+void masked_keccak_init_rounds(masked_keccak_ctx *ctx, size_t rate, uint8_t domain_sep, int nrounds);
+// Absorb secret bytes (masked with fresh randomness).
+void masked_keccak_absorb(masked_keccak_ctx *ctx, const uint8_t *input, size_t input_len);
+// Absorb public bytes (share 0 only, no randomness).
+void masked_keccak_absorb_public(masked_keccak_ctx *ctx, const uint8_t *input, size_t input_len);
+// Absorb one segment of any sensitivity (see masked_input_segment_t).
+void masked_keccak_absorb_segment(masked_keccak_ctx *ctx, const masked_input_segment_t *segment);
+void masked_keccak_finalize(masked_keccak_ctx *ctx);
+void masked_keccak_squeeze(masked_keccak_ctx *ctx, uint8_t *output, size_t output_len);
+
+/**
+ * Copy a sponge context, e.g. a snapshot taken after a common prefix.
+ *
+ * Absorb a shared prefix once, then clone the snapshot for each suffix
+ * instead of re-absorbing (and re-masking) the prefix every time:
+ *   masked_keccak_init(&prefix, 168, DOMAIN_SHAKE);
+ *   masked_keccak_absorb(&prefix, seed, 32);
+ *   for each (i, j):
+ *       masked_keccak_clone(&xof, &prefix, 1);
+ *       masked_keccak_absorb_public(&xof, ij, 2);
+ *       masked_keccak_squeeze(&xof, block, 168);
+ *
+ * With refresh set, every lane of the copy gets a fresh sharing
+ * (25 * (MASKING_N - 1) random words), so no two clones hold the same
+ * share values. Without it, clones share their masks until the next
+ * permutation, which is cheaper but lets an attacker combine traces of
+ * several clones on the same shares.
+ */
+void masked_keccak_clone(masked_keccak_ctx *dst, const masked_keccak_ctx *src, int refresh);
+
+// --- Caller-provided workspace ---
+
+/**
+ * Everything a hash call needs beyond a few words of stack: the sponge
+ * context and the permutation scratch (Chi randomness, round buffers,
+ * backend state copy). Declare one statically per execution context:
+ *   static masked_keccak_workspace_t ws;
+ *   masked_sha3_256_ws(&ws, digest, msg, msg_len);
+ *
+ * The *_ws calls and a context started with masked_keccak_init_ws() keep
+ * no state or randomness array on the stack, no VLA and no block buffer
+ * (output is recombined one lane at a time), so their frames are small
+ * and fixed; the -fstack-usage output (.su files of the Debug build)
+ * gives the bound per function. Use them from interrupt handlers and RTOS
+ * tasks with small stacks. A workspace must not be shared by two
+ * contexts that can run at the same time; clones of ws.ctx share ws.scratch.
+ *
+ * Every one-shot hash has a *_ws form except the x4 calls: they exist to
+ * run four states in lock-step, and the batched round keeps its Theta
+ * columns and the four states on the stack by design. Where the stack is
+ * bounded, four *_ws calls give the same outputs. KangarooTwelve runs two
+ * sponges at once and takes a masked_k12_workspace_t instead.
+ */
+typedef struct masked_keccak_workspace {
+    masked_keccak_ctx ctx;
+    masked_keccak_scratch_t scratch;
+} masked_keccak_workspace_t;
+
+// Streaming: start ws->ctx with its permutation buffers in ws->scratch,
+// then use &ws->ctx with the usual absorb / finalize / squeeze calls.
+void masked_keccak_init_ws(masked_keccak_workspace_t *ws, size_t rate, uint8_t domain_sep);
+// Same, over Keccak-p[1600, nrounds].
+void masked_keccak_init_rounds_ws(masked_keccak_workspace_t *ws, size_t rate, uint8_t domain_sep, int nrounds);
+
+// One-shot hashes over a secret message, as masked_sha3_256() etc.
+void masked_sha3_224_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                        const uint8_t *input, size_t input_len);
+void masked_sha3_256_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                        const uint8_t *input, size_t input_len);
+void masked_sha3_384_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                        const uint8_t *input, size_t input_len);
+void masked_sha3_512_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                        const uint8_t *input, size_t input_len);
+void masked_shake128_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                        const uint8_t *input, size_t input_len);
+void masked_shake256_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                        const uint8_t *input, size_t input_len);
+
+// Pre-shared input, as masked_sha3_256_shared() etc.
+void masked_sha3_256_shared_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                               const masked_uint64_t *lanes, size_t input_len);
+void masked_sha3_512_shared_ws(masked_keccak_workspace_t *ws, uint8_t *output,
+                               const masked_uint64_t *lanes, size_t input_len);
+void masked_shake128_shared_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                               const masked_uint64_t *lanes, size_t input_len);
+void masked_shake256_shared_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                               const masked_uint64_t *lanes, size_t input_len);
+
+// Masked output, as masked_sha3_256_to_shares() etc.
+void masked_sha3_256_to_shares_ws(masked_keccak_workspace_t *ws, masked_uint64_t *output,
+                                  const uint8_t *input, size_t input_len);
+void masked_sha3_512_to_shares_ws(masked_keccak_workspace_t *ws, masked_uint64_t *output,
+                                  const uint8_t *input, size_t input_len);
+void masked_shake128_to_shares_ws(masked_keccak_workspace_t *ws, masked_uint64_t *output, size_t output_len,
+                                  const uint8_t *input, size_t input_len);
+void masked_shake256_to_shares_ws(masked_keccak_workspace_t *ws, masked_uint64_t *output, size_t output_len,
+                                  const uint8_t *input, size_t input_len);
+
+// TurboSHAKE, as masked_turboshake128() / masked_turboshake256().
+void masked_turboshake128_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                             const uint8_t *input, size_t input_len, uint8_t domain_sep);
+void masked_turboshake256_ws(masked_keccak_workspace_t *ws, uint8_t *output, size_t output_len,
+                             const uint8_t *input, size_t input_len, uint8_t domain_sep);
+
+// KangarooTwelve keeps the final node open while it hashes each leaf.
+typedef struct masked_k12_workspace {
+    masked_keccak_ctx final_node;
+    masked_keccak_ctx leaf;              // Current leaf of an input over one chunk
+    masked_uint64_t cv[4];               // Its masked chaining value
+    masked_keccak_scratch_t scratch;     // Permutation buffers of both sponges
+} masked_k12_workspace_t;
+
+// KangarooTwelve, as masked_kangarootwelve().
+void masked_kangarootwelve_ws(masked_k12_workspace_t *ws, uint8_t *output, size_t output_len,
+                              const uint8_t *input, size_t input_len,
+                              const uint8_t *custom, size_t custom_len);
+
 /**
  * Computes SHA3-224 (28 bytes output) using masked Keccak.
  * @param output Buffer to receive 28-byte hash.
@@ -52,6 +264,29 @@ void masked_sha3_384(uint8_t *output, const uint8_t *input, size_t input_len);
  */
 void masked_sha3_512(uint8_t *output, const uint8_t *input, size_t input_len);
 
+// --- Pre-shared input ---
+// Hash a secret that is already split into shares, e.g. the output of
+// another masked computation. input_len is in bytes; lanes holds
+// ceil(input_len / 8) masked lanes, bytes in little-endian lane order.
+
+void masked_sha3_256_shared(uint8_t *output, const masked_uint64_t *lanes, size_t input_len);
+void masked_sha3_512_shared(uint8_t *output, const masked_uint64_t *lanes, size_t input_len);
+void masked_shake128_shared(uint8_t *output, size_t output_len,
+                            const masked_uint64_t *lanes, size_t input_len);
+void masked_shake256_shared(uint8_t *output, size_t output_len,
+                            const masked_uint64_t *lanes, size_t input_len);
+
+// --- Masked output ---
+// Output stays split into shares for masked consumers: ceil(len / 8)
+// masked lanes, output bytes in little-endian lane order.
+
+void masked_sha3_256_to_shares(masked_uint64_t *output, const uint8_t *input, size_t input_len);
+void masked_sha3_512_to_shares(masked_uint64_t *output, const uint8_t *input, size_t input_len);
+void masked_shake128_to_shares(masked_uint64_t *output, size_t output_len,
+                               const uint8_t *input, size_t input_len);
+void masked_shake256_to_shares(masked_uint64_t *output, size_t output_len,
+                               const uint8_t *input, size_t input_len);
+
 // --- Extendable Output Functions (XOFs) ---
 
 /**
@@ -70,8 +305,48 @@ void masked_shake128(uint8_t *output, size_t output_len,
 void masked_shake256(uint8_t *output, size_t output_len,
                      const uint8_t *input, size_t input_len);
 
+// --- Batched hashing (x4) ---
+// Four independent messages of the same length, hashed in lock-step with
+// masked_keccak_p1600_x4(). output[n] equals the single-message function
+// on input[n]; all inputs are secret. The per-message randomness is
+// unchanged, the gain is in the shared round loop (and vector lanes on
+// the host SIMD backend).
+
+void masked_sha3_256_x4(uint8_t *const output[4], const uint8_t *const input[4], size_t input_len);
+void masked_sha3_512_x4(uint8_t *const output[4], const uint8_t *const input[4], size_t input_len);
+void masked_shake128_x4(uint8_t *const output[4], size_t output_len,
+                        const uint8_t *const input[4], size_t input_len);
+void masked_shake256_x4(uint8_t *const output[4], size_t output_len,
+                        const uint8_t *const input[4], size_t input_len);
+
+// --- TurboSHAKE / KangarooTwelve (RFC 9861) ---
+// Same sponge over the 12-round Keccak-p[1600, 12], about twice the
+// throughput of SHAKE.
+
+/**
+ * Computes TurboSHAKE128 / TurboSHAKE256 (XOF).
+ * @param domain_sep Domain byte D, 0x01..0x7F (DOMAIN_TURBOSHAKE = 0x1F by default).
+ */
+void masked_turboshake128(uint8_t *output, size_t output_len,
+                          const uint8_t *input, size_t input_len, uint8_t domain_sep);
+void masked_turboshake256(uint8_t *output, size_t output_len,
+                          const uint8_t *input, size_t input_len, uint8_t domain_sep);
+
+/**
+ * Computes KangarooTwelve (XOF) over TurboSHAKE128.
+ *
+ * The message is secret; the customization string is public. Inputs longer
+ * than one 8 KiB chunk use the K12 tree: each further chunk is a leaf
+ * whose 32-byte chaining value is kept masked and absorbed share-wise
+ * into the final node.
+ * @param custom Customization string (may be empty).
+ */
+void masked_kangarootwelve(uint8_t *output, size_t output_len,
+                           const uint8_t *input, size_t input_len,
+                           const uint8_t *custom, size_t custom_len);
+
 #ifdef __cplusplus
 }
 #endif
 
-#endif // MASKED_KECCAK_H
+#endif // SHA_SHAKE_H
@@ -254,6 +254,9 @@ void HAL_RNG_MspInit(RNG_HandleTypeDef* hrng)
     /* USER CODE END RNG_MspInit 0 */
     /* Peripheral clock enable */
     __HAL_RCC_RNG_CLK_ENABLE();
+    /* RNG interrupt Init */
+    HAL_NVIC_SetPriority(HASH_RNG_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(HASH_RNG_IRQn);
     /* USER CODE BEGIN RNG_MspInit 1 */
 
     /* USER CODE END RNG_MspInit 1 */
@@ -277,6 +280,9 @@ void HAL_RNG_MspDeInit(RNG_HandleTypeDef* hrng)
     /* USER CODE END RNG_MspDeInit 0 */
     /* Peripheral clock disable */
     __HAL_RCC_RNG_CLK_DISABLE();
+
+    /* RNG interrupt DeInit */
+    HAL_NVIC_DisableIRQ(HASH_RNG_IRQn);
     /* USER CODE BEGIN RNG_MspDeInit 1 */
 
     /* USER CODE END RNG_MspDeInit 1 */
@@ -94,6 +94,36 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Copy the CCM-RAM initializers and zero fill the CCM-RAM bss. */
+  ldr r0, =_sccmram
+  ldr r1, =_eccmram
+  ldr r2, =_siccmram
+  movs r3, #0
+  b LoopCopyCcmInit
+
+CopyCcmInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyCcmInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyCcmInit
+
+  ldr r2, =_sccmbss
+  ldr r4, =_eccmbss
+  movs r3, #0
+  b LoopFillZeroCcmbss
+
+FillZeroCcmbss:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroCcmbss:
+  cmp r2, r4
+  bcc FillZeroCcmbss
+
 /* Call static constructors */
     bl __libc_init_array
 /* Call the application's entry point.*/
@@ -8,8 +8,17 @@ C_SRCS += \
 ../Core/Src/debug_log.c \
 ../Core/Src/global_rng.c \
 ../Core/Src/main.c \
+../Core/Src/masked_bench.c \
+../Core/Src/masked_ccm.c \
 ../Core/Src/masked_gadgets.c \
 ../Core/Src/masked_keccak.c \
+../Core/Src/masked_keccak_bi32.c \
+../Core/Src/masked_keccak_soa.c \
+../Core/Src/masked_prg.c \
+../Core/Src/rng_pool.c \
+../Core/Src/rng_pool_hal.c \
+../Core/Src/rng_source_hal.c \
+../Core/Src/rng_source_seeded.c \
 ../Core/Src/sha_shake.c \
 ../Core/Src/stm32f4xx_hal_msp.c \
 ../Core/Src/stm32f4xx_it.c \
@@ -18,12 +27,25 @@ C_SRCS += \
 ../Core/Src/system_stm32f4xx.c \
 ../Core/Src/test.c 
 
+S_SRCS += \
+../Core/Src/masked_keccak_asm.s 
+
 OBJS += \
 ./Core/Src/debug_log.o \
 ./Core/Src/global_rng.o \
 ./Core/Src/main.o \
+./Core/Src/masked_bench.o \
+./Core/Src/masked_ccm.o \
 ./Core/Src/masked_gadgets.o \
 ./Core/Src/masked_keccak.o \
+./Core/Src/masked_keccak_asm.o \
+./Core/Src/masked_keccak_bi32.o \
+./Core/Src/masked_keccak_soa.o \
+./Core/Src/masked_prg.o \
+./Core/Src/rng_pool.o \
+./Core/Src/rng_pool_hal.o \
+./Core/Src/rng_source_hal.o \
+./Core/Src/rng_source_seeded.o \
 ./Core/Src/sha_shake.o \
 ./Core/Src/stm32f4xx_hal_msp.o \
 ./Core/Src/stm32f4xx_it.o \
@@ -32,12 +54,24 @@ OBJS += \
 ./Core/Src/system_stm32f4xx.o \
 ./Core/Src/test.o 
 
+S_DEPS += \
+./Core/Src/masked_keccak_asm.d 
+
 C_DEPS += \
 ./Core/Src/debug_log.d \
 ./Core/Src/global_rng.d \
 ./Core/Src/main.d \
+./Core/Src/masked_bench.d \
+./Core/Src/masked_ccm.d \
 ./Core/Src/masked_gadgets.d \
 ./Core/Src/masked_keccak.d \
+./Core/Src/masked_keccak_bi32.d \
+./Core/Src/masked_keccak_soa.d \
+./Core/Src/masked_prg.d \
+./Core/Src/rng_pool.d \
+./Core/Src/rng_pool_hal.d \
+./Core/Src/rng_source_hal.d \
+./Core/Src/rng_source_seeded.d \
 ./Core/Src/sha_shake.d \
 ./Core/Src/stm32f4xx_hal_msp.d \
 ./Core/Src/stm32f4xx_it.d \
@@ -51,10 +85,13 @@ C_DEPS += \
 Core/Src/%.o Core/Src/%.su Core/Src/%.cyclo: ../Core/Src/%.c Core/Src/subdir.mk
 	arm-none-eabi-gcc "$<" -mcpu=cortex-m4 -std=gnu11 -g3 -DDEBUG -DUSE_HAL_DRIVER -DSTM32F407xx -c -I../USB_HOST/App -I../USB_HOST/Target -I../Core/Inc -I../Drivers/STM32F4xx_HAL_Driver/Inc -I../Drivers/STM32F4xx_HAL_Driver/Inc/Legacy -I../Middlewares/ST/STM32_USB_Host_Library/Core/Inc -I../Middlewares/ST/STM32_USB_Host_Library/Class/CDC/Inc -I../Drivers/CMSIS/Device/ST/STM32F4xx/Include -I../Drivers/CMSIS/Include -O0 -ffunction-sections -fdata-sections -Wall -fstack-usage -fcyclomatic-complexity -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" --specs=nano.specs -mfpu=fpv4-sp-d16 -mfloat-abi=hard -mthumb -o "$@"
 
+Core/Src/%.o: ../Core/Src/%.s Core/Src/subdir.mk
+	arm-none-eabi-gcc -mcpu=cortex-m4 -g3 -DDEBUG -c -x assembler-with-cpp -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" --specs=nano.specs -mfpu=fpv4-sp-d16 -mfloat-abi=hard -mthumb -o "$@" "$<"
+
 clean: clean-Core-2f-Src
 
 clean-Core-2f-Src:
-	-$(RM) ./Core/Src/debug_log.cyclo ./Core/Src/debug_log.d ./Core/Src/debug_log.o ./Core/Src/debug_log.su ./Core/Src/global_rng.cyclo ./Core/Src/global_rng.d ./Core/Src/global_rng.o ./Core/Src/global_rng.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/masked_gadgets.cyclo ./Core/Src/masked_gadgets.d ./Core/Src/masked_gadgets.o ./Core/Src/masked_gadgets.su ./Core/Src/masked_keccak.cyclo ./Core/Src/masked_keccak.d ./Core/Src/masked_keccak.o ./Core/Src/masked_keccak.su ./Core/Src/sha_shake.cyclo ./Core/Src/sha_shake.d ./Core/Src/sha_shake.o ./Core/Src/sha_shake.su ./Core/Src/stm32f4xx_hal_msp.cyclo ./Core/Src/stm32f4xx_hal_msp.d ./Core/Src/stm32f4xx_hal_msp.o ./Core/Src/stm32f4xx_hal_msp.su ./Core/Src/stm32f4xx_it.cyclo ./Core/Src/stm32f4xx_it.d ./Core/Src/stm32f4xx_it.o ./Core/Src/stm32f4xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32f4xx.cyclo ./Core/Src/system_stm32f4xx.d ./Core/Src/system_stm32f4xx.o ./Core/Src/system_stm32f4xx.su ./Core/Src/test.cyclo ./Core/Src/test.d ./Core/Src/test.o ./Core/Src/test.su
+	-$(RM) ./Core/Src/debug_log.cyclo ./Core/Src/debug_log.d ./Core/Src/debug_log.o ./Core/Src/debug_log.su ./Core/Src/global_rng.cyclo ./Core/Src/global_rng.d ./Core/Src/global_rng.o ./Core/Src/global_rng.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/masked_bench.cyclo ./Core/Src/masked_bench.d ./Core/Src/masked_bench.o ./Core/Src/masked_bench.su ./Core/Src/masked_ccm.cyclo ./Core/Src/masked_ccm.d ./Core/Src/masked_ccm.o ./Core/Src/masked_ccm.su ./Core/Src/masked_gadgets.cyclo ./Core/Src/masked_gadgets.d ./Core/Src/masked_gadgets.o ./Core/Src/masked_gadgets.su ./Core/Src/masked_keccak.cyclo ./Core/Src/masked_keccak.d ./Core/Src/masked_keccak.o ./Core/Src/masked_keccak.su ./Core/Src/masked_keccak_asm.d ./Core/Src/masked_keccak_asm.o ./Core/Src/masked_keccak_bi32.cyclo ./Core/Src/masked_keccak_bi32.d ./Core/Src/masked_keccak_bi32.o ./Core/Src/masked_keccak_bi32.su ./Core/Src/masked_keccak_soa.cyclo ./Core/Src/masked_keccak_soa.d ./Core/Src/masked_keccak_soa.o ./Core/Src/masked_keccak_soa.su ./Core/Src/masked_prg.cyclo ./Core/Src/masked_prg.d ./Core/Src/masked_prg.o ./Core/Src/masked_prg.su ./Core/Src/rng_pool.cyclo ./Core/Src/rng_pool.d ./Core/Src/rng_pool.o ./Core/Src/rng_pool.su ./Core/Src/rng_pool_hal.cyclo ./Core/Src/rng_pool_hal.d ./Core/Src/rng_pool_hal.o ./Core/Src/rng_pool_hal.su ./Core/Src/rng_source_hal.cyclo ./Core/Src/rng_source_hal.d ./Core/Src/rng_source_hal.o ./Core/Src/rng_source_hal.su ./Core/Src/rng_source_seeded.cyclo ./Core/Src/rng_source_seeded.d ./Core/Src/rng_source_seeded.o ./Core/Src/rng_source_seeded.su ./Core/Src/sha_shake.cyclo ./Core/Src/sha_shake.d ./Core/Src/sha_shake.o ./Core/Src/sha_shake.su ./Core/Src/stm32f4xx_hal_msp.cyclo ./Core/Src/stm32f4xx_hal_msp.d ./Core/Src/stm32f4xx_hal_msp.o ./Core/Src/stm32f4xx_hal_msp.su ./Core/Src/stm32f4xx_it.cyclo ./Core/Src/stm32f4xx_it.d ./Core/Src/stm32f4xx_it.o ./Core/Src/stm32f4xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32f4xx.cyclo ./Core/Src/system_stm32f4xx.d ./Core/Src/system_stm32f4xx.o ./Core/Src/system_stm32f4xx.su ./Core/Src/test.cyclo ./Core/Src/test.d ./Core/Src/test.o ./Core/Src/test.su
 
 .PHONY: clean-Core-2f-Src
 
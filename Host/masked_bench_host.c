@@ -0,0 +1,10 @@
+#include "masked_bench.h"
+#include "rng_pool.h"
+
+// Host entry point for the benchmark suite: the same CSV as the target
+// prints over USART2, on stdout. Build one binary per MASKING_ORDER.
+int main(void) {
+    rng_pool_init();
+    masked_bench_run();
+    return 0;
+}
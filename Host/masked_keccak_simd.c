@@ -0,0 +1,494 @@
+#include "masked_keccak_simd.h"
+#include "masked_keccak.h"
+#include "masked_gadgets.h"
+#include "params.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MASKED_SIMD_X86 1
+#else
+#define MASKED_SIMD_X86 0
+#endif
+
+// Host vector backend for offline tooling (leakage simulation, test-vector
+// generation, reference checks).
+//
+// Each masked lane is one vector: share i sits in 64-bit element i, unused
+// elements stay zero. Theta, Rho, Pi, the NOT in Chi and Iota are then
+// single vector operations per lane. The masked AND keeps the ISW
+// structure of masked_and(): the diagonal terms are one vector AND, and
+// for each share distance k the cross terms a_{j-k} b_j ^ a_j b_{j-k} are
+// formed in element j and masked with r[j-k][j] before they are added.
+// Randomness comes from chi_row_random(), so the budget (and the
+// MASKED_CHI_GADGET choice) is the same as on the target.
+
+// Rho offsets and Pi destinations, lane index x + 5*y.
+static const uint8_t simd_rho[25] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14
+};
+
+static const uint8_t simd_pi[25] = {
+     0, 10, 20,  5, 15,
+    16,  1, 11, 21,  6,
+     7, 17,  2, 12, 22,
+    23,  8, 18,  3, 13,
+    14, 24,  9, 19,  4
+};
+
+//Portable fallback: the fused C round.
+static void p1600_scalar(masked_uint64_t state[5][5], int nrounds) {
+    for (int i = 24 - nrounds; i < 24; i++)
+        masked_keccak_round_fused(state, RC[i]);
+}
+
+#if MASKED_SIMD_X86
+__attribute__((target("avx2")))
+static inline __m256i avx2_rol(__m256i x, unsigned int n) {
+    return _mm256_or_si256(_mm256_sll_epi64(x, _mm_cvtsi32_si128(n)),
+                           _mm256_srl_epi64(x, _mm_cvtsi32_si128(64 - n)));
+}
+#endif
+
+#if MASKED_SIMD_X86 && MASKING_N <= 4
+//======AVX2: up to 4 shares per __m256i======
+
+//Vector ISW AND; r is the masked_and() randomness matrix.
+__attribute__((target("avx2")))
+static __m256i avx2_and(__m256i a, __m256i b, const uint64_t r[MASKING_N][MASKING_N]) {
+    __m256i out = _mm256_and_si256(a, b);
+
+    for (int k = 1; k < MASKING_N; k++) {
+        uint64_t lo[4] = { 0 }, hi[4] = { 0 };
+        int32_t idx[8];
+        int64_t keep[4];
+
+        for (int i = 0; i + k < MASKING_N; i++) {
+            lo[i] = r[i][i + k];        // share i, pair (i, i+k)
+            hi[i + k] = r[i][i + k];    // share i+k, pair (i, i+k)
+        }
+        for (int e = 0; e < 8; e++)
+            idx[e] = 2 * (((e / 2) - k) & 3) + (e & 1);
+        for (int j = 0; j < 4; j++)
+            keep[j] = (j >= k) ? -1 : 0;
+
+        __m256i perm = _mm256_loadu_si256((const __m256i *)idx);
+        __m256i ak = _mm256_permutevar8x32_epi32(a, perm);   // element j: a_{j-k}
+        __m256i bk = _mm256_permutevar8x32_epi32(b, perm);   // element j: b_{j-k}
+        __m256i cross = _mm256_xor_si256(_mm256_and_si256(ak, b), _mm256_and_si256(a, bk));
+        cross = _mm256_and_si256(cross, _mm256_loadu_si256((const __m256i *)keep));
+
+        out = _mm256_xor_si256(out, _mm256_loadu_si256((const __m256i *)lo));
+        out = _mm256_xor_si256(out, _mm256_xor_si256(cross, _mm256_loadu_si256((const __m256i *)hi)));
+    }
+    return out;
+}
+
+__attribute__((target("avx2")))
+static void p1600_avx2(masked_uint64_t state[5][5], int nrounds) {
+    __m256i S[25], B[25], C[5];
+    const __m256i share0 = _mm256_set_epi64x(0, 0, 0, -1);
+
+    for (int i = 0; i < 25; i++) {
+        uint64_t lane[4] = { 0 };
+        memcpy(lane, state[i % 5][i / 5].share, sizeof(state[0][0].share));
+        S[i] = _mm256_loadu_si256((const __m256i *)lane);
+    }
+
+    for (int round = 24 - nrounds; round < 24; round++) {
+        // Theta
+        for (int x = 0; x < 5; x++)
+            C[x] = _mm256_xor_si256(_mm256_xor_si256(S[x], S[x + 5]),
+                   _mm256_xor_si256(_mm256_xor_si256(S[x + 10], S[x + 15]), S[x + 20]));
+        for (int x = 0; x < 5; x++) {
+            __m256i D = _mm256_xor_si256(C[(x + 4) % 5], avx2_rol(C[(x + 1) % 5], 1));
+            for (int y = 0; y < 25; y += 5)
+                S[x + y] = _mm256_xor_si256(S[x + y], D);
+        }
+
+        // Rho + Pi
+        for (int i = 0; i < 25; i++)
+            B[simd_pi[i]] = avx2_rol(S[i], simd_rho[i]);
+
+        // Chi: NOT flips share 0 only
+        for (int y = 0; y < 25; y += 5) {
+            uint64_t r[5][MASKING_N][MASKING_N];
+            chi_row_random(r);
+            for (int x = 0; x < 5; x++) {
+                __m256i nb = _mm256_xor_si256(B[y + (x + 1) % 5], share0);
+                S[y + x] = _mm256_xor_si256(B[y + x], avx2_and(nb, B[y + (x + 2) % 5], r[x]));
+            }
+        }
+
+        // Iota: public constant into share 0
+        S[0] = _mm256_xor_si256(S[0], _mm256_set_epi64x(0, 0, 0, (long long)RC[round]));
+    }
+
+    for (int i = 0; i < 25; i++) {
+        uint64_t lane[4];
+        _mm256_storeu_si256((__m256i *)lane, S[i]);
+        memcpy(state[i % 5][i / 5].share, lane, sizeof(state[0][0].share));
+    }
+}
+#endif
+
+#if MASKED_SIMD_X86 && MASKING_N <= 8
+//======AVX-512: up to 8 shares per __m512i======
+
+//Vector ISW AND; r is the masked_and() randomness matrix.
+__attribute__((target("avx512f")))
+static __m512i avx512_and(__m512i a, __m512i b, const uint64_t r[MASKING_N][MASKING_N]) {
+    __m512i out = _mm512_and_si512(a, b);
+    const __m512i lanes = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+
+    for (int k = 1; k < MASKING_N; k++) {
+        uint64_t lo[8] = { 0 }, hi[8] = { 0 };
+
+        for (int i = 0; i + k < MASKING_N; i++) {
+            lo[i] = r[i][i + k];
+            hi[i + k] = r[i][i + k];
+        }
+
+        __m512i perm = _mm512_and_si512(_mm512_sub_epi64(lanes, _mm512_set1_epi64(k)),
+                                        _mm512_set1_epi64(7));
+        __m512i ak = _mm512_permutexvar_epi64(perm, a);      // element j: a_{j-k}
+        __m512i bk = _mm512_permutexvar_epi64(perm, b);      // element j: b_{j-k}
+        __mmask8 keep = (__mmask8)(0xFF << k);
+        __m512i cross = _mm512_maskz_xor_epi64(keep, _mm512_and_si512(ak, b), _mm512_and_si512(a, bk));
+
+        out = _mm512_xor_si512(out, _mm512_loadu_si512(lo));
+        out = _mm512_xor_si512(out, _mm512_xor_si512(cross, _mm512_loadu_si512(hi)));
+    }
+    return out;
+}
+
+__attribute__((target("avx512f")))
+static void p1600_avx512(masked_uint64_t state[5][5], int nrounds) {
+    __m512i S[25], B[25], C[5];
+    const __m512i share0 = _mm512_set_epi64(0, 0, 0, 0, 0, 0, 0, -1);
+
+    for (int i = 0; i < 25; i++) {
+        uint64_t lane[8] = { 0 };
+        memcpy(lane, state[i % 5][i / 5].share, sizeof(state[0][0].share));
+        S[i] = _mm512_loadu_si512(lane);
+    }
+
+    for (int round = 24 - nrounds; round < 24; round++) {
+        // Theta
+        for (int x = 0; x < 5; x++)
+            C[x] = _mm512_xor_si512(_mm512_xor_si512(S[x], S[x + 5]),
+                   _mm512_xor_si512(_mm512_xor_si512(S[x + 10], S[x + 15]), S[x + 20]));
+        for (int x = 0; x < 5; x++) {
+            __m512i D = _mm512_xor_si512(C[(x + 4) % 5], _mm512_rol_epi64(C[(x + 1) % 5], 1));
+            for (int y = 0; y < 25; y += 5)
+                S[x + y] = _mm512_xor_si512(S[x + y], D);
+        }
+
+        // Rho + Pi
+        for (int i = 0; i < 25; i++)
+            B[simd_pi[i]] = _mm512_rolv_epi64(S[i], _mm512_set1_epi64(simd_rho[i]));
+
+        // Chi: NOT flips share 0 only
+        for (int y = 0; y < 25; y += 5) {
+            uint64_t r[5][MASKING_N][MASKING_N];
+            chi_row_random(r);
+            for (int x = 0; x < 5; x++) {
+                __m512i nb = _mm512_xor_si512(B[y + (x + 1) % 5], share0);
+                S[y + x] = _mm512_xor_si512(B[y + x], avx512_and(nb, B[y + (x + 2) % 5], r[x]));
+            }
+        }
+
+        // Iota: public constant into share 0
+        S[0] = _mm512_xor_si512(S[0], _mm512_set_epi64(0, 0, 0, 0, 0, 0, 0, (long long)RC[round]));
+    }
+
+    for (int i = 0; i < 25; i++) {
+        uint64_t lane[8];
+        _mm512_storeu_si512(lane, S[i]);
+        memcpy(state[i % 5][i / 5].share, lane, sizeof(state[0][0].share));
+    }
+}
+#endif
+
+#if MASKED_SIMD_X86
+//======Batched: instance n in element n, one vector per (lane, share)======
+
+// Unlike the per-lane paths above, the vector width is filled with
+// instances, so these work for any MASKING_N. The masked AND is the
+// generic masked_and() share loop on vectors; each instance draws its own
+// Chi row randomness.
+
+__attribute__((target("avx2")))
+static void p1600_avx2_x4(masked_uint64_t (*state)[5][5], int nrounds) {
+    __m256i S[25][MASKING_N], B[25][MASKING_N], C[5][MASKING_N];
+
+    for (int l = 0; l < 25; l++)
+        for (int i = 0; i < MASKING_N; i++)
+            S[l][i] = _mm256_set_epi64x((long long)state[3][l % 5][l / 5].share[i],
+                                        (long long)state[2][l % 5][l / 5].share[i],
+                                        (long long)state[1][l % 5][l / 5].share[i],
+                                        (long long)state[0][l % 5][l / 5].share[i]);
+
+    for (int round = 24 - nrounds; round < 24; round++) {
+        // Theta
+        for (int x = 0; x < 5; x++)
+            for (int i = 0; i < MASKING_N; i++)
+                C[x][i] = _mm256_xor_si256(_mm256_xor_si256(S[x][i], S[x + 5][i]),
+                          _mm256_xor_si256(_mm256_xor_si256(S[x + 10][i], S[x + 15][i]), S[x + 20][i]));
+        for (int x = 0; x < 5; x++)
+            for (int i = 0; i < MASKING_N; i++) {
+                __m256i D = _mm256_xor_si256(C[(x + 4) % 5][i], avx2_rol(C[(x + 1) % 5][i], 1));
+                for (int y = 0; y < 25; y += 5)
+                    S[x + y][i] = _mm256_xor_si256(S[x + y][i], D);
+            }
+
+        // Rho + Pi
+        for (int l = 0; l < 25; l++)
+            for (int i = 0; i < MASKING_N; i++)
+                B[simd_pi[l]][i] = avx2_rol(S[l][i], simd_rho[l]);
+
+        // Chi
+        for (int y = 0; y < 25; y += 5) {
+            uint64_t r[4][5][MASKING_N][MASKING_N];
+            for (int n = 0; n < 4; n++)
+                chi_row_random(r[n]);
+
+            for (int x = 0; x < 5; x++) {
+                const __m256i *a = B[y + (x + 1) % 5], *b = B[y + (x + 2) % 5];
+                __m256i na[MASKING_N], t[MASKING_N];
+
+                for (int i = 0; i < MASKING_N; i++)
+                    na[i] = a[i];
+                na[0] = _mm256_xor_si256(na[0], _mm256_set1_epi64x(-1));
+
+                for (int i = 0; i < MASKING_N; i++)
+                    t[i] = _mm256_and_si256(na[i], b[i]);
+                for (int i = 0; i < MASKING_N; i++)
+                    for (int j = i + 1; j < MASKING_N; j++) {
+                        __m256i rij = _mm256_set_epi64x((long long)r[3][x][i][j], (long long)r[2][x][i][j],
+                                                        (long long)r[1][x][i][j], (long long)r[0][x][i][j]);
+                        __m256i cross = _mm256_xor_si256(_mm256_and_si256(na[i], b[j]),
+                                                         _mm256_and_si256(na[j], b[i]));
+                        t[i] = _mm256_xor_si256(t[i], rij);
+                        t[j] = _mm256_xor_si256(t[j], _mm256_xor_si256(cross, rij));
+                    }
+
+                for (int i = 0; i < MASKING_N; i++)
+                    S[y + x][i] = _mm256_xor_si256(B[y + x][i], t[i]);
+            }
+        }
+
+        // Iota
+        S[0][0] = _mm256_xor_si256(S[0][0], _mm256_set1_epi64x((long long)RC[round]));
+    }
+
+    for (int l = 0; l < 25; l++)
+        for (int i = 0; i < MASKING_N; i++) {
+            uint64_t v[4];
+            _mm256_storeu_si256((__m256i *)v, S[l][i]);
+            for (int n = 0; n < 4; n++)
+                state[n][l % 5][l / 5].share[i] = v[n];
+        }
+}
+
+__attribute__((target("avx512f")))
+static void p1600_avx512_x8(masked_uint64_t (*state)[5][5], int nrounds) {
+    __m512i S[25][MASKING_N], B[25][MASKING_N], C[5][MASKING_N];
+
+    for (int l = 0; l < 25; l++)
+        for (int i = 0; i < MASKING_N; i++) {
+            uint64_t v[8];
+            for (int n = 0; n < 8; n++)
+                v[n] = state[n][l % 5][l / 5].share[i];
+            S[l][i] = _mm512_loadu_si512(v);
+        }
+
+    for (int round = 24 - nrounds; round < 24; round++) {
+        // Theta
+        for (int x = 0; x < 5; x++)
+            for (int i = 0; i < MASKING_N; i++)
+                C[x][i] = _mm512_xor_si512(_mm512_xor_si512(S[x][i], S[x + 5][i]),
+                          _mm512_xor_si512(_mm512_xor_si512(S[x + 10][i], S[x + 15][i]), S[x + 20][i]));
+        for (int x = 0; x < 5; x++)
+            for (int i = 0; i < MASKING_N; i++) {
+                __m512i D = _mm512_xor_si512(C[(x + 4) % 5][i], _mm512_rol_epi64(C[(x + 1) % 5][i], 1));
+                for (int y = 0; y < 25; y += 5)
+                    S[x + y][i] = _mm512_xor_si512(S[x + y][i], D);
+            }
+
+        // Rho + Pi
+        for (int l = 0; l < 25; l++) {
+            __m512i rot = _mm512_set1_epi64(simd_rho[l]);
+            for (int i = 0; i < MASKING_N; i++)
+                B[simd_pi[l]][i] = _mm512_rolv_epi64(S[l][i], rot);
+        }
+
+        // Chi
+        for (int y = 0; y < 25; y += 5) {
+            uint64_t r[8][5][MASKING_N][MASKING_N];
+            for (int n = 0; n < 8; n++)
+                chi_row_random(r[n]);
+
+            for (int x = 0; x < 5; x++) {
+                const __m512i *a = B[y + (x + 1) % 5], *b = B[y + (x + 2) % 5];
+                __m512i na[MASKING_N], t[MASKING_N];
+
+                for (int i = 0; i < MASKING_N; i++)
+                    na[i] = a[i];
+                na[0] = _mm512_xor_si512(na[0], _mm512_set1_epi64(-1));
+
+                for (int i = 0; i < MASKING_N; i++)
+                    t[i] = _mm512_and_si512(na[i], b[i]);
+                for (int i = 0; i < MASKING_N; i++)
+                    for (int j = i + 1; j < MASKING_N; j++) {
+                        uint64_t v[8];
+                        for (int n = 0; n < 8; n++)
+                            v[n] = r[n][x][i][j];
+                        __m512i rij = _mm512_loadu_si512(v);
+                        __m512i cross = _mm512_xor_si512(_mm512_and_si512(na[i], b[j]),
+                                                         _mm512_and_si512(na[j], b[i]));
+                        t[i] = _mm512_xor_si512(t[i], rij);
+                        t[j] = _mm512_xor_si512(t[j], _mm512_xor_si512(cross, rij));
+                    }
+
+                for (int i = 0; i < MASKING_N; i++)
+                    S[y + x][i] = _mm512_xor_si512(B[y + x][i], t[i]);
+            }
+        }
+
+        // Iota
+        S[0][0] = _mm512_xor_si512(S[0][0], _mm512_set1_epi64((long long)RC[round]));
+    }
+
+    for (int l = 0; l < 25; l++)
+        for (int i = 0; i < MASKING_N; i++) {
+            uint64_t v[8];
+            _mm512_storeu_si512(v, S[l][i]);
+            for (int n = 0; n < 8; n++)
+                state[n][l % 5][l / 5].share[i] = v[n];
+        }
+}
+#endif
+
+//======Run-Time Selection======
+
+static masked_simd_isa_t simd_isa;
+static int simd_selected;
+static int simd_forced;
+
+//Whether this CPU and this MASKING_N can run the given path.
+static int simd_supported(masked_simd_isa_t isa) {
+    switch (isa) {
+#if MASKED_SIMD_X86 && MASKING_N <= 4
+    case MASKED_SIMD_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#if MASKED_SIMD_X86 && MASKING_N <= 8
+    case MASKED_SIMD_AVX512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    case MASKED_SIMD_SCALAR:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+masked_simd_isa_t masked_keccak_simd_isa(void) {
+    if (!simd_selected) {
+        // Prefer the narrowest unit that holds every share.
+        if (simd_supported(MASKED_SIMD_AVX2))
+            simd_isa = MASKED_SIMD_AVX2;
+        else if (simd_supported(MASKED_SIMD_AVX512))
+            simd_isa = MASKED_SIMD_AVX512;
+        else
+            simd_isa = MASKED_SIMD_SCALAR;
+        simd_selected = 1;
+    }
+    return simd_isa;
+}
+
+int masked_keccak_simd_force(masked_simd_isa_t isa) {
+    if (!simd_supported(isa))
+        return 0;
+    simd_isa = isa;
+    simd_selected = 1;
+    simd_forced = 1;
+    return 1;
+}
+
+const char *masked_keccak_simd_isa_name(masked_simd_isa_t isa) {
+    switch (isa) {
+    case MASKED_SIMD_AVX2:   return "avx2";
+    case MASKED_SIMD_AVX512: return "avx512";
+    default:                 return "scalar";
+    }
+}
+
+void masked_keccak_p1600_simd(masked_uint64_t state[5][5], int nrounds) {
+    switch (masked_keccak_simd_isa()) {
+#if MASKED_SIMD_X86 && MASKING_N <= 4
+    case MASKED_SIMD_AVX2:
+        p1600_avx2(state, nrounds);
+        break;
+#endif
+#if MASKED_SIMD_X86 && MASKING_N <= 8
+    case MASKED_SIMD_AVX512:
+        p1600_avx512(state, nrounds);
+        break;
+#endif
+    default:
+        p1600_scalar(state, nrounds);
+        break;
+    }
+}
+
+//Widest unit for the batched paths. Instances fill the vector, so
+// MASKING_N does not matter; a forced path caps the choice.
+static masked_simd_isa_t simd_batch_isa(void) {
+    masked_simd_isa_t cap = simd_forced ? simd_isa : MASKED_SIMD_AVX512;
+
+#if MASKED_SIMD_X86
+    if (cap >= MASKED_SIMD_AVX512 && __builtin_cpu_supports("avx512f"))
+        return MASKED_SIMD_AVX512;
+    if (cap >= MASKED_SIMD_AVX2 && __builtin_cpu_supports("avx2"))
+        return MASKED_SIMD_AVX2;
+#else
+    (void)cap;
+#endif
+    return MASKED_SIMD_SCALAR;
+}
+
+void masked_keccak_p1600_simd_x4(masked_uint64_t state[4][5][5], int nrounds) {
+#if MASKED_SIMD_X86
+    if (simd_batch_isa() != MASKED_SIMD_SCALAR) {
+        p1600_avx2_x4(state, nrounds);
+        return;
+    }
+#endif
+    for (int n = 0; n < 4; n++)
+        p1600_scalar(state[n], nrounds);
+}
+
+void masked_keccak_p1600_simd_x8(masked_uint64_t state[8][5][5], int nrounds) {
+#if MASKED_SIMD_X86
+    switch (simd_batch_isa()) {
+    case MASKED_SIMD_AVX512:
+        p1600_avx512_x8(state, nrounds);
+        return;
+    case MASKED_SIMD_AVX2:
+        p1600_avx2_x4(state, nrounds);
+        p1600_avx2_x4(state + 4, nrounds);
+        return;
+    default:
+        break;
+    }
+#endif
+    for (int n = 0; n < 8; n++)
+        p1600_scalar(state[n], nrounds);
+}
@@ -0,0 +1,34 @@
+#ifndef MASKED_KECCAK_SIMD_H
+#define MASKED_KECCAK_SIMD_H
+
+#include "masked_types.h"
+
+// Host (x86-64) backend: one vector register per masked lane, shares in the
+// 64-bit elements. AVX2 holds up to 4 shares, AVX-512 up to 8. The code
+// path is picked at run time from the CPU features; without a fitting
+// vector unit the portable C round is used.
+
+typedef enum {
+    MASKED_SIMD_SCALAR = 0,
+    MASKED_SIMD_AVX2 = 1,
+    MASKED_SIMD_AVX512 = 2
+} masked_simd_isa_t;
+
+// Keccak-p[1600, nrounds] with the selected code path (KECCAK_BACKEND_HOST_SIMD).
+void masked_keccak_p1600_simd(masked_uint64_t state[5][5], int nrounds);
+
+// Four / eight independent states in lock-step (masked_keccak_p1600_x4 / _x8):
+// one vector per lane and share, instance n in element n. Any MASKING_N.
+void masked_keccak_p1600_simd_x4(masked_uint64_t state[4][5][5], int nrounds);
+void masked_keccak_p1600_simd_x8(masked_uint64_t state[8][5][5], int nrounds);
+
+// Per-lane code path in use, detected on first call.
+masked_simd_isa_t masked_keccak_simd_isa(void);
+const char *masked_keccak_simd_isa_name(masked_simd_isa_t isa);
+
+// Force a code path, e.g. to cross-check paths against each other; the
+// batched paths then use no wider unit than the forced one.
+// Returns 0 if this CPU or MASKING_N cannot run it (selection unchanged).
+int masked_keccak_simd_force(masked_simd_isa_t isa);
+
+#endif // MASKED_KECCAK_SIMD_H
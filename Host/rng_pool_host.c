@@ -0,0 +1,40 @@
+#include "rng_pool.h"
+#include <stdint.h>
+#include "rng_pool_host.h"
+#include "rng_source.h"
+
+// Linux stand-in for the RNG pool port; words come from the
+// MASKED_RNG_SOURCE backend (getrandom() or the seeded stream).
+//
+// There is no interrupt on the host, so a pending request is recorded and
+// "delivered" when rng_pool_host_irq() is called, either explicitly (to model
+// background refill between hash calls) or by a consumer that ran dry.
+
+static int rng_pool_host_pending;
+
+void rng_pool_port_start(void) {
+    rng_pool_host_pending = 1;
+}
+
+/**
+ * Deliver one simulated data-ready interrupt.
+ *
+ * @return 1 if a word was delivered, 0 if no request was pending
+ */
+int rng_pool_host_irq(void) {
+    if (!rng_pool_host_pending)
+        return 0;
+    rng_pool_host_pending = 0;
+    rng_pool_on_word(rng_source_word());
+    return 1;
+}
+
+// Run simulated interrupts until the pool is full (or n words were delivered).
+void rng_pool_host_refill(size_t n) {
+    while (n-- > 0 && rng_pool_host_irq()) {
+    }
+}
+
+void rng_pool_port_wait(void) {
+    rng_pool_host_irq();
+}
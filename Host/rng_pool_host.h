@@ -0,0 +1,10 @@
+#ifndef RNG_POOL_HOST_H
+#define RNG_POOL_HOST_H
+
+#include <stddef.h>
+
+// Host-only controls for the simulated RNG data-ready interrupt.
+int rng_pool_host_irq(void);
+void rng_pool_host_refill(size_t n);
+
+#endif // RNG_POOL_HOST_H
@@ -0,0 +1,34 @@
+#include "rng_source.h"
+
+#if MASKED_RNG_SOURCE == RNG_SOURCE_GETRANDOM
+#include <stddef.h>
+#include <sys/random.h>
+
+// Linux kernel CSPRNG. Words are fetched 64 at a time so the masking
+// randomness does not cost one system call per word.
+
+#define RNG_SOURCE_BATCH 64
+
+static uint32_t rng_source_buf[RNG_SOURCE_BATCH];
+static size_t rng_source_next = RNG_SOURCE_BATCH;
+
+uint32_t rng_source_word(void) {
+    if (rng_source_next == RNG_SOURCE_BATCH) {
+        uint8_t *p = (uint8_t *)rng_source_buf;
+        size_t left = sizeof(rng_source_buf);
+        while (left > 0) {
+            ssize_t n = getrandom(p, left, 0);
+            if (n > 0) {
+                p += n;
+                left -= (size_t)n;
+            }
+        }
+        rng_source_next = 0;
+    }
+    return rng_source_buf[rng_source_next++];
+}
+
+void rng_source_seed(uint64_t seed) {
+    (void)seed;
+}
+#endif